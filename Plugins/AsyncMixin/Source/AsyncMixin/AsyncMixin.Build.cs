@@ -6,6 +6,9 @@ public class AsyncMixin : ModuleRules
 {
 	public AsyncMixin(ReadOnlyTargetRules Target) : base(Target)
 	{
+		// AsyncLoadAwait() is a C++20 coroutine awaitable
+		CppStandard = CppStandardVersion.Cpp20;
+
 		PublicDependencyModuleNames.AddRange(
 			new string[]
 			{
@@ -23,6 +26,7 @@ public class AsyncMixin : ModuleRules
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
+				"AssetRegistry",
 			}
 		);
 	}
@@ -0,0 +1,1460 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixin.h"
+
+#include "Algo/AllOf.h"
+#include "AsyncMixinAccessRecorder.h"
+#include "AsyncMixinActorPool.h"
+#include "AsyncMixinAdmission.h"
+#include "AsyncMixinCancellation.h"
+#include "AsyncMixinHandleCache.h"
+#include "AsyncMixinRequestCoalescer.h"
+#include "AsyncMixinScheduler.h"
+#include "AsyncMixinStats.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "UObject/UObjectGlobals.h"
+
+#include <coroutine>
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixin, Log, All);
+
+namespace AsyncMixinCVars
+{
+	static int32 MaxPooledLoadingStates = 128;
+	static FAutoConsoleVariableRef CVarMaxPooledLoadingStates(
+		TEXT("AsyncMixin.MaxPooledLoadingStates"),
+		MaxPooledLoadingStates,
+		TEXT("Maximum number of released loading states kept around for reuse by other mix-ins."));
+}
+
+TArray<TSharedRef<FAsyncMixin::FLoadingState>> FAsyncMixin::LoadingStatePool;
+
+namespace AsyncMixinPreload
+{
+	/**
+	 * Preloads the bundles by requesting only the paths of their load set that aren't resident yet.  The resident ones are
+	 * returned in OutResidentObjects for the step to keep alive, the way the asset manager's preload handle would.  When
+	 * every path is already loaded, e.g. from an earlier preload of a screen being re-entered, no handle is made at all and
+	 * the step completes synchronously.  Ids the asset manager can't resolve go through PreloadPrimaryAssets as before.
+	 */
+	static TSharedPtr<FStreamableHandle> PreloadMissingBundles(const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& LoadBundles, TAsyncLoadPriority Priority,
+	                                                           TArray<TStrongObjectPtr<UObject>>& OutResidentObjects)
+	{
+		UAssetManager& AssetManager = UAssetManager::Get();
+		const bool bLoadRecursive = true;
+
+		TSet<FSoftObjectPath> LoadSet;
+		for (const FPrimaryAssetId& AssetId : AssetIds)
+		{
+			if (!AssetManager.GetPrimaryAssetLoadSet(LoadSet, AssetId, LoadBundles, bLoadRecursive))
+			{
+				return AssetManager.PreloadPrimaryAssets(AssetIds, LoadBundles, bLoadRecursive, FStreamableDelegate(), Priority);
+			}
+		}
+
+		if (LoadSet.Num() == 0)
+		{
+			return nullptr;
+		}
+
+		TArray<FSoftObjectPath> MissingPaths;
+		for (const FSoftObjectPath& SoftObjectPath : LoadSet)
+		{
+			if (FAsyncMixinRequestCoalescer::IsFullyLoaded(SoftObjectPath))
+			{
+				OutResidentObjects.Emplace(SoftObjectPath.ResolveObject());
+			}
+			else
+			{
+				MissingPaths.Add(SoftObjectPath);
+			}
+		}
+
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("Preload of %d assets needs %d of %d paths"), AssetIds.Num(), MissingPaths.Num(), LoadSet.Num());
+		AsyncMixinStats::RecordPreload(LoadSet.Num(), MissingPaths.Num());
+
+		if (MissingPaths.Num() == 0)
+		{
+			return nullptr;
+		}
+
+		return UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(MissingPaths), FStreamableDelegate(), Priority, false, false, TEXT("AsyncMixinPreload"));
+	}
+}
+
+FAsyncMixin::FAsyncMixin()
+{
+}
+
+FAsyncMixin::~FAsyncMixin()
+{
+	check(IsInGameThread());
+
+	// Releasing the loading state will cancel any pending loadings it was 
+	// monitoring, and shouldn't receive any future callbacks for completion.
+	ReleaseLoadingState();
+
+	// Other threads may still be holding the queue, make sure nothing it drains comes back to us.
+	if (RequestQueue.IsValid())
+	{
+		RequestQueue->DetachFromOwner();
+	}
+
+	AsyncMixinStats::ForgetOwner(this);
+}
+
+int32 FAsyncMixin::GetNumActiveTickers()
+{
+	return AsyncMixinStats::GetActiveTickers();
+}
+
+const FAsyncMixin::FLoadingState& FAsyncMixin::GetLoadingStateConst() const
+{
+	check(IsInGameThread());
+	check(LoadingState.IsValid());
+	return *LoadingState;
+}
+
+FAsyncMixin::FLoadingState& FAsyncMixin::GetLoadingState()
+{
+	check(IsInGameThread());
+
+	if (!LoadingState.IsValid())
+	{
+		if (LoadingStatePool.Num() > 0)
+		{
+			LoadingState = LoadingStatePool.Pop(/*bAllowShrinking*/false);
+			LoadingState->SetOwner(*this);
+		}
+		else
+		{
+			LoadingState = MakeShared<FLoadingState>(*this);
+		}
+	}
+
+	return *LoadingState;
+}
+
+bool FAsyncMixin::HasLoadingState() const
+{
+	check(IsInGameThread());
+
+	return LoadingState.IsValid();
+}
+
+void FAsyncMixin::ReleaseLoadingState()
+{
+	check(IsInGameThread());
+
+	TSharedPtr<FLoadingState> ReleasedState = MoveTemp(LoadingState);
+
+	if (ReleasedState.IsValid())
+	{
+		ReleasedState->DetachFromOwner();
+
+		// Only pool the state if this is the last reference to it.  Anything else holding it, most likely a callback
+		// further up the stack keeping it alive, destroys it normally once that unwinds.
+		if ((ReleasedState.GetSharedReferenceCount() == 1) && (LoadingStatePool.Num() < AsyncMixinCVars::MaxPooledLoadingStates))
+		{
+			ReleasedState->ResetForReuse();
+			LoadingStatePool.Add(ReleasedState.ToSharedRef());
+		}
+	}
+}
+
+void FAsyncMixin::CancelAsyncLoading()
+{
+	// Don't create the loading state if we don't have anything pending.
+	if (HasLoadingState())
+	{
+		GetLoadingState().CancelAndDestroy();
+	}
+}
+
+bool FAsyncMixin::IsAsyncLoadingInProgress() const
+{
+	// Don't create the loading state if we don't have anything pending.
+	if (HasLoadingState())
+	{
+		return GetLoadingStateConst().IsLoadingInProgress();
+	}
+
+	return false;
+}
+
+bool FAsyncMixin::IsLoadingInProgressOrPending() const
+{
+	if (HasLoadingState())
+	{
+		return GetLoadingStateConst().IsLoadingInProgressOrPending();
+	}
+
+	return false;
+}
+
+TSharedRef<FAsyncMixinRequestQueue, ESPMode::ThreadSafe> FAsyncMixin::GetAsyncRequestQueue()
+{
+	check(IsInGameThread());
+
+	if (!RequestQueue.IsValid())
+	{
+		RequestQueue = MakeShareable(new FAsyncMixinRequestQueue(*this));
+	}
+
+	return RequestQueue.ToSharedRef();
+}
+
+void FAsyncMixin::SetAsyncLoadingPriority(TAsyncLoadPriority Priority)
+{
+	// Nothing queued, nothing to reprioritize.
+	if (HasLoadingState())
+	{
+		GetLoadingState().SetPriority(Priority);
+	}
+}
+
+void FAsyncMixin::AsyncLoad(FSoftObjectPath SoftObjectPath, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority)
+{
+	GetLoadingState().AsyncLoad(SoftObjectPath, DelegateToCall, Priority);
+}
+
+void FAsyncMixin::AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority)
+{
+	GetLoadingState().AsyncLoad(SoftObjectPaths, DelegateToCall, Priority);
+}
+
+void FAsyncMixin::AsyncLoad(FSoftObjectPath SoftObjectPath, const FAsyncLoadDeadline& Deadline, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority)
+{
+	GetLoadingState().AsyncLoad(SoftObjectPath, DelegateToCall, Priority, Deadline);
+}
+
+void FAsyncMixin::AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, const FAsyncLoadDeadline& Deadline, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority)
+{
+	GetLoadingState().AsyncLoad(SoftObjectPaths, DelegateToCall, Priority, Deadline);
+}
+
+void FAsyncMixin::AsyncLoadAndPrewarm(UWorld* World, const FSoftObjectPath& ActorClassPath, int32 Count, const FSimpleDelegate& Callback, TAsyncLoadPriority Priority)
+{
+	const TWeakObjectPtr<UWorld> WeakWorld(World);
+	const TSharedRef<bool> bLoaded = MakeShared<bool>(false);
+
+	AsyncLoad(ActorClassPath, FSimpleDelegate::CreateLambda([WeakWorld, ActorClassPath, Count, bLoaded]()
+	{
+		*bLoaded = true;
+
+		if (UAsyncMixinActorPool* ActorPool = UAsyncMixinActorPool::Get(WeakWorld.Get()))
+		{
+			ActorPool->Prewarm(Cast<UClass>(ActorClassPath.ResolveObject()), Count);
+		}
+	}), Priority);
+
+	// Pooled actors are constructed on the pool's tick, check on it every frame until it's warm.
+	AsyncCondition(MakeShared<FAsyncCondition>([WeakWorld, ActorClassPath, bLoaded]()
+	{
+		if (!*bLoaded)
+		{
+			return EAsyncConditionResult::TryAgain;
+		}
+
+		const UAsyncMixinActorPool* ActorPool = UAsyncMixinActorPool::Get(WeakWorld.Get());
+		const bool bPrewarming = ActorPool && ActorPool->IsPrewarming(Cast<UClass>(ActorClassPath.ResolveObject()));
+		return bPrewarming ? EAsyncConditionResult::TryAgain : EAsyncConditionResult::Complete;
+	}, FAsyncConditionPollingPolicy::FixedInterval(0.0f)), Callback);
+}
+
+void FAsyncMixin::AsyncPreloadPrimaryAssetsAndBundles(const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& LoadBundles, const FSimpleDelegate& DelegateToCall,
+                                                      TAsyncLoadPriority Priority)
+{
+	GetLoadingState().AsyncPreloadPrimaryAssetsAndBundles(AssetIds, LoadBundles, DelegateToCall, Priority);
+}
+
+void FAsyncMixin::AsyncCondition(TSharedRef<FAsyncCondition> Condition, const FSimpleDelegate& Callback)
+{
+	GetLoadingState().AsyncCondition(Condition, Callback);
+}
+
+void FAsyncMixin::AsyncEvent(const FSimpleDelegate& Callback)
+{
+	GetLoadingState().AsyncEvent(Callback);
+}
+
+void FAsyncMixin::StartAsyncLoading()
+{
+	// If we don't actually have any loading state because they've not queued anything to load,
+	// just immediately start and finish the operation by calling the callbacks, no point in allocating
+	// the memory just to de-allocate it.
+	if (IsLoadingInProgressOrPending())
+	{
+		GetLoadingState().Start();
+	}
+	else
+	{
+		OnStartedLoading();
+		OnFinishedLoading();
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncMixin::FLoadingState::FLoadingState(FAsyncMixin& InOwner)
+	: Owner(&InOwner)
+{
+}
+
+FAsyncMixin::FLoadingState::~FLoadingState()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixin_FLoadingState_DestroyThisMemoryDelegate);
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Destroy LoadingState (Done)"), this);
+
+	// If we get destroyed, need to cancel whatever we're doing and cancel any
+	// pending destruction - as we're already on the way out.
+	CancelOnly(/*bDestroying*/true);
+	CancelDestroyThisMemory(/*bDestroying*/true);
+
+	ensure(CallbackDepth == 0);
+	CallbackDepth = 0;
+	FreePendingSteps();
+}
+
+void FAsyncMixin::FLoadingState::DetachFromOwner()
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Release LoadingState"), this);
+
+	CancelOnly(/*bDestroying*/true);
+	CancelDestroyThisMemory(/*bDestroying*/true);
+
+	Owner = nullptr;
+}
+
+void FAsyncMixin::FLoadingState::ResetForReuse()
+{
+	check(Owner == nullptr);
+
+	// Nothing can be executing these anymore, we only pool states nobody else references.
+	check(CallbackDepth == 0);
+	FreePendingSteps();
+}
+
+void FAsyncMixin::FLoadingState::FreePendingSteps()
+{
+	// A user callback further up the stack may belong to one of these steps, they'll be freed on a later cancel.
+	if (CallbackDepth > 0)
+	{
+		return;
+	}
+
+	for (FAsyncStep* Step : AsyncStepsPendingDestruction)
+	{
+		StepPool.Free(Step);
+	}
+
+	AsyncStepsPendingDestruction.Reset();
+}
+
+template <typename... ArgTypes>
+FAsyncMixin::FLoadingState::FAsyncStep& FAsyncMixin::FLoadingState::AddStep(ArgTypes&&... Args)
+{
+	FAsyncStep* Step = StepPool.Allocate(Forward<ArgTypes>(Args)...);
+	AsyncSteps.Add(Step);
+
+	if (SequenceStartTime == 0.0)
+	{
+		SequenceStartTime = Step->GetEnqueueTime();
+		bHasCalledBack = false;
+	}
+
+	return *Step;
+}
+
+void FAsyncMixin::FLoadingState::SetOwner(FAsyncMixin& InOwner)
+{
+	check(Owner == nullptr);
+	Owner = &InOwner;
+}
+
+void FAsyncMixin::FLoadingState::CancelOnly(bool bDestroying)
+{
+	if (!bDestroying)
+	{
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Cancel"), this);
+	}
+
+	CancelStartTimer();
+
+	for (FAsyncStep* Step : AsyncSteps)
+	{
+		Step->Cancel();
+	}
+
+	// Moving the steps to another array so we don't crash.
+	// There was an issue where the Step would get corrupted because we were calling Reset() on the array, the user
+	// callback of one of these may still be on the stack.  Both arrays keep their capacity for the next requests.
+	FreePendingSteps();
+	const int32 FirstCanceledStep = AsyncStepsPendingDestruction.Num();
+	AsyncStepsPendingDestruction.Append(AsyncSteps);
+	AsyncSteps.Reset();
+
+	bPreloadedBundles = false;
+	bHasStarted = false;
+	CurrentAsyncStep = 0;
+	SequenceStartTime = 0.0;
+
+	// Last, once we're in a consistent state, the destructors of the coroutine locals can run anything.
+	DestroySuspendedCoroutines(FirstCanceledStep);
+}
+
+void FAsyncMixin::FLoadingState::DestroySuspendedCoroutines(int32 FirstStep)
+{
+	// Don't let a nested cancel free the steps out from under us, and only visit our own range, anything canceled
+	// further down is handled by that cancel.
+	++CallbackDepth;
+
+	const int32 LastStep = AsyncStepsPendingDestruction.Num();
+	for (int32 StepIndex = FirstStep; StepIndex < LastStep; ++StepIndex)
+	{
+		AsyncStepsPendingDestruction[StepIndex]->DestroySuspendedCoroutine();
+	}
+
+	--CallbackDepth;
+}
+
+void FAsyncMixin::FLoadingState::CancelAndDestroy()
+{
+	CancelOnly(/*bDestroying*/false);
+	RequestDestroyThisMemory();
+}
+
+void FAsyncMixin::FLoadingState::CancelDestroyThisMemory(bool bDestroying)
+{
+	// If we've schedule the memory to be deleted we need to abort that.
+	if (IsPendingDestroy())
+	{
+		if (!bDestroying)
+		{
+			UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Destroy LoadingState (Canceled)"), this);
+		}
+
+		FAsyncMixinScheduler::UnscheduleReap(*this);
+	}
+}
+
+void FAsyncMixin::FLoadingState::RequestDestroyThisMemory()
+{
+	// If we're already pending to destroy this memory, just ignore.
+	if (!IsPendingDestroy())
+	{
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Destroy LoadingState (Requested)"), this);
+
+		FAsyncMixinScheduler::Get().ScheduleReap(*this);
+	}
+}
+
+void FAsyncMixin::FLoadingState::Reap()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixin_FLoadingState_Reap);
+
+	// Remove any memory we were using.
+	Owner->ReleaseLoadingState();
+}
+
+void FAsyncMixin::FLoadingState::CancelStartTimer()
+{
+	FAsyncMixinScheduler::UnscheduleStart(*this);
+}
+
+void FAsyncMixin::FLoadingState::Start()
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Start (Current Progress %d/%d)"), this, CurrentAsyncStep + 1, AsyncSteps.Num());
+
+	// Cancel any pending kickoff load requests.
+	CancelStartTimer();
+
+	bool bStartingStepFound = false;
+
+	if (!bHasStarted)
+	{
+		bHasStarted = true;
+		Owner->OnStartedLoading();
+	}
+	
+	TryCompleteAsyncLoading();
+}
+
+void FAsyncMixin::FLoadingState::AsyncLoad(FSoftObjectPath SoftObjectPath, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority,
+                                           const FAsyncLoadDeadline& Deadline)
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncLoad '%s' (Priority %d)"), this, *SoftObjectPath.ToString(), Priority);
+
+	FAsyncMixinHandleCache::Get().Touch(SoftObjectPath);
+
+	AddLoadStep(TArray<FSoftObjectPath>{ MoveTemp(SoftObjectPath) }, DelegateToCall, Priority, Deadline);
+}
+
+void FAsyncMixin::FLoadingState::AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority,
+                                           const FAsyncLoadDeadline& Deadline)
+{
+	// Only build the path list when someone is going to see it.
+	if (UE_LOG_ACTIVE(LogAsyncMixin, Verbose))
+	{
+		const FString& Paths = FString::JoinBy(SoftObjectPaths, TEXT(", "), [](const FSoftObjectPath& SoftObjectPath) { return FString::Printf(TEXT("'%s'"), *SoftObjectPath.ToString()); });
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncLoad [%s] (Priority %d)"), this, *Paths, Priority);
+	}
+
+	FAsyncMixinHandleCache::Get().Touch(SoftObjectPaths);
+
+	AddLoadStep(TArray<FSoftObjectPath>(SoftObjectPaths), DelegateToCall, Priority, Deadline);
+}
+
+void FAsyncMixin::FLoadingState::AsyncLoadAndResume(TArray<FSoftObjectPath>&& SoftObjectPaths, void* CoroutineAddress, TAsyncLoadPriority Priority)
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncLoadAndResume %d paths (Priority %d)"), this, SoftObjectPaths.Num(), Priority);
+
+	FAsyncMixinHandleCache::Get().Touch(SoftObjectPaths);
+
+	AddLoadStep(MoveTemp(SoftObjectPaths), FSimpleDelegate(), Priority, FAsyncLoadDeadline()).SetCoroutine(CoroutineAddress);
+}
+
+void FAsyncMixin::FLoadingState::AsyncLoadNow(TArray<FSoftObjectPath>&& SoftObjectPaths, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority)
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncLoadNow %d paths (Priority %d)"), this, SoftObjectPaths.Num(), Priority);
+
+	FAsyncMixinHandleCache::Get().Touch(SoftObjectPaths);
+
+	AddLoadStep(MoveTemp(SoftObjectPaths), DelegateToCall, Priority, FAsyncLoadDeadline(), /*bCoalesce*/false);
+}
+
+FAsyncMixin::FLoadingState::FAsyncStep& FAsyncMixin::FLoadingState::AddLoadStep(TArray<FSoftObjectPath>&& SoftObjectPaths, const FSimpleDelegate& DelegateToCall,
+                                                                                TAsyncLoadPriority Priority, const FAsyncLoadDeadline& Deadline, bool bCoalesce)
+{
+	if (FAsyncMixinAccessRecorder::IsEnabled())
+	{
+		FAsyncMixinAccessRecorder::Get().RecordAccess(Owner->GetAsyncLoadingAccessKey(), SoftObjectPaths);
+	}
+
+	FAsyncMixinRequestCoalescer& Coalescer = FAsyncMixinRequestCoalescer::Get();
+
+	FAsyncStep* Step = nullptr;
+	if (bCoalesce && Coalescer.ShouldCoalesce(SoftObjectPaths))
+	{
+		// Wait for this frame's batch, other mix-ins asking for the same paths share the one request.
+		TSharedRef<FAsyncMixinLoadBatch> Batch = Coalescer.Request(SoftObjectPaths, Priority);
+		Step = &AddStep(DelegateToCall, Batch, MoveTemp(SoftObjectPaths), Priority);
+	}
+	else if (!Algo::AllOf(SoftObjectPaths, &FAsyncMixinRequestCoalescer::IsFullyLoaded))
+	{
+		// Not batched with anything, but it still has to wait for the admission controller to have budget for it.
+		TSharedRef<FAsyncMixinLoadBatch> Batch = Coalescer.RequestNow(SoftObjectPaths, Priority);
+		Step = &AddStep(DelegateToCall, Batch, MoveTemp(SoftObjectPaths), Priority);
+	}
+	else
+	{
+		// Nothing to read, request it right away so the step completes synchronously.
+		Step = &AddStep(
+			DelegateToCall,
+			UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(SoftObjectPaths), FStreamableDelegate(), Priority, false, false, TEXT("AsyncMixin")),
+			Priority
+		);
+	}
+
+	// Listen from the start rather than once the step reaches the front, so we know when it completed even if an earlier
+	// step holds back its callback.  Fails if it's already complete, the callback then stamps it.
+	Step->BindCompleteDelegate(FSimpleDelegate::CreateSP(this, &FLoadingState::HandleStepComplete, Step));
+
+	if (Deadline.IsSet())
+	{
+		Step->SetDeadline(*this, Deadline);
+	}
+
+	TryScheduleStart();
+
+	return *Step;
+}
+
+void FAsyncMixin::FLoadingState::AsyncPreloadPrimaryAssetsAndBundles(const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& LoadBundles, const FSimpleDelegate& DelegateToCall,
+                                                                      TAsyncLoadPriority Priority)
+{
+	if (UE_LOG_ACTIVE(LogAsyncMixin, Verbose))
+	{
+		const FString& Assets = FString::JoinBy(AssetIds, TEXT(", "), [](const FPrimaryAssetId& AssetId) { return AssetId.ToString(); });
+		const FString& Bundles = FString::JoinBy(LoadBundles, TEXT(", "), [](const FName& LoadBundle) { return LoadBundle.ToString(); });
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X]  AsyncPreload Assets [%s], Bundles[%s]"), this, *Assets, *Bundles);
+	}
+
+	TSharedPtr<FStreamableHandle> StreamingHandle;
+	TArray<TStrongObjectPtr<UObject>> ResidentObjects;
+
+	if (AssetIds.Num() > 0)
+	{
+		bPreloadedBundles = true;
+
+		StreamingHandle = AsyncMixinPreload::PreloadMissingBundles(AssetIds, LoadBundles, Priority, ResidentObjects);
+	}
+
+	FAsyncStep& Step = AddStep(DelegateToCall, StreamingHandle, Priority);
+	Step.HoldResidentObjects(MoveTemp(ResidentObjects));
+
+	TryScheduleStart();
+}
+
+void FAsyncMixin::FLoadingState::SetPriority(TAsyncLoadPriority Priority)
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] SetPriority %d"), this, Priority);
+
+	for (FAsyncStep* Step : AsyncSteps)
+	{
+		Step->SetPriority(Priority);
+	}
+}
+
+void FAsyncMixin::FLoadingState::AsyncCondition(TSharedRef<FAsyncCondition> Condition, const FSimpleDelegate& DelegateToCall)
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncCondition '0x%X'"), this, &Condition.Get());
+
+	AddStep(DelegateToCall, TSharedPtr<FAsyncCondition>(Condition));
+
+	TryScheduleStart();
+}
+
+void FAsyncMixin::FLoadingState::AsyncEvent(const FSimpleDelegate& DelegateToCall)
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncEvent"), this);
+
+	AddStep(DelegateToCall);
+
+	TryScheduleStart();
+}
+
+void FAsyncMixin::FLoadingState::TryScheduleStart()
+{
+	CancelDestroyThisMemory(/*bDestroying*/false);
+
+	// In the event the user forgets to start async loading, we'll begin doing it next frame.
+	FAsyncMixinScheduler::Get().ScheduleStart(*this);
+}
+
+bool FAsyncMixin::FLoadingState::IsLoadingInProgress() const
+{
+	if (AsyncSteps.Num() > 0)
+	{
+		if (CurrentAsyncStep < AsyncSteps.Num())
+		{
+			if (CurrentAsyncStep == (AsyncSteps.Num() - 1))
+			{
+				return AsyncSteps[CurrentAsyncStep]->IsLoadingInProgress();
+			}
+
+			// If we know it's a valid index, but not the last one, then we know we're still loading,
+			// if it's not a valid index, we know there's no loading, or we're beyond any loading.
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FAsyncMixin::FLoadingState::IsLoadingInProgressOrPending() const
+{
+	return FAsyncMixinScheduler::IsStartScheduled(*this) || IsLoadingInProgress();
+}
+
+bool FAsyncMixin::FLoadingState::IsPendingDestroy() const
+{
+	return FAsyncMixinScheduler::IsReapScheduled(*this);
+}
+
+void FAsyncMixin::FLoadingState::TryCompleteAsyncLoading()
+{
+	// If we haven't started when we get this callback it means we've already completed
+	// and this is some other callback finishing on the same frame/stack that we need to avoid
+	// doing anything with until the memory is finished being deleted.
+	if (!bHasStarted)
+	{
+		return;
+	}
+
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] TryCompleteAsyncLoading - (Current Progress %d/%d)"), this, CurrentAsyncStep + 1, AsyncSteps.Num());
+
+	// Keep ourselves alive, a user callback may release the state from the owner while we're still walking the steps.
+	TSharedRef<FLoadingState> KeepAlive = AsShared();
+
+	if (Owner->GetAsyncLoadingCompletionMode() == EAsyncMixinCompletionMode::OutOfOrder)
+	{
+		TryCompleteAsyncLoadingOutOfOrder();
+	}
+	else
+	{
+		TryCompleteAsyncLoadingInOrder();
+	}
+	
+	// If we're done loading, and bHasStarted is still true (meaning this is the first time we're encountering a request to complete)
+	// try and complete.  It's entirely possible that a user callback might append new work, which they immediately start, which
+	// immediately tries to complete, which might create a case where we're now inside of TryCompleteAsyncLoading, which then
+	// calls Start, which then calls TryCompleteAsyncLoading, so when we come back out of the stack, we need to avoid trying to
+	// complete the async loading N+ times.
+	if (IsLoadingComplete() && bHasStarted)
+	{
+		CompleteAsyncLoading();
+	}
+}
+
+void FAsyncMixin::FLoadingState::HandleStepComplete(FAsyncStep* Step)
+{
+	// Canceled steps unbind this, so the step is still ours.
+	Step->MarkCompleteObserved(FPlatformTime::Seconds());
+
+	TryCompleteAsyncLoading();
+}
+
+void FAsyncMixin::FLoadingState::TryCompleteAsyncLoadingInOrder()
+{
+	while (CurrentAsyncStep < AsyncSteps.Num())
+	{
+		FAsyncStep* Step = AsyncSteps[CurrentAsyncStep];
+		if (Step->HasExecutedUserCallback())
+		{
+			// Can only happen if the completion mode was switched to in order part way through the sequence.
+			CurrentAsyncStep++;
+		}
+		else if (Step->IsLoadingInProgress())
+		{
+			if (!Step->IsCompleteDelegateBound())
+			{
+				UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step %d - Still Loading (Listening)"), this, CurrentAsyncStep + 1);
+				const bool bBound = Step->BindCompleteDelegate(FSimpleDelegate::CreateSP(this, &FLoadingState::TryCompleteAsyncLoading));
+				ensureMsgf(bBound, TEXT("This is not intended to return false.  We're checking if it's loaded above, this should definitely return true."));
+			}
+			else
+			{
+				UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step %d - Still Loading (Waiting)"), this, CurrentAsyncStep + 1);
+			}
+
+			break;
+		}
+		else
+		{
+			UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step %d - Completed (Calling User)"), this, CurrentAsyncStep + 1);
+
+			// Always advance the CurrentAsyncStep, before calling the user callback, it's possible they might
+			// add new work, and try and start again, so we need to be ready for the next bit.
+			CurrentAsyncStep++;
+
+			RetainCompletedStep(*Step);
+			ExecuteStep(*Step);
+		}
+	}
+}
+
+void FAsyncMixin::FLoadingState::TryCompleteAsyncLoadingOutOfOrder()
+{
+	// CurrentAsyncStep is the first step whose callback hasn't run.  Every step after it up to the next barrier
+	// may run as soon as it's complete, a barrier only runs once it's at the front and waits on everything before it.
+	int32 StepIndex = CurrentAsyncStep;
+	while (StepIndex < AsyncSteps.Num())
+	{
+		FAsyncStep* Step = AsyncSteps[StepIndex];
+		const bool bIsFront = (StepIndex == CurrentAsyncStep);
+
+		if (Step->HasExecutedUserCallback())
+		{
+			if (bIsFront)
+			{
+				CurrentAsyncStep++;
+			}
+			StepIndex++;
+			continue;
+		}
+
+		if (Step->IsBarrier() && !bIsFront)
+		{
+			UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step %d - Barrier (Waiting on Step %d)"), this, StepIndex + 1, CurrentAsyncStep + 1);
+			break;
+		}
+
+		if (Step->IsLoadingInProgress())
+		{
+			if (!Step->IsCompleteDelegateBound())
+			{
+				UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step %d - Still Loading (Listening)"), this, StepIndex + 1);
+				const bool bBound = Step->BindCompleteDelegate(FSimpleDelegate::CreateSP(this, &FLoadingState::TryCompleteAsyncLoading));
+				ensureMsgf(bBound, TEXT("This is not intended to return false.  We're checking if it's loaded above, this should definitely return true."));
+			}
+
+			if (Step->IsBarrier())
+			{
+				break;
+			}
+
+			StepIndex++;
+			continue;
+		}
+
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step %d - Completed (Calling User)"), this, StepIndex + 1);
+
+		if (bIsFront)
+		{
+			CurrentAsyncStep++;
+		}
+
+		RetainCompletedStep(*Step);
+		ExecuteStep(*Step);
+
+		// The user may have queued more work or canceled everything, rescan from the front.
+		StepIndex = CurrentAsyncStep;
+	}
+}
+
+void FAsyncMixin::FLoadingState::ExecuteStep(FAsyncStep& Step)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAsyncMixin_ExecuteStep);
+
+	// Loads are stamped by HandleStepComplete as they complete, this only catches the ones that completed synchronously.
+	const double Now = FPlatformTime::Seconds();
+	Step.MarkCompleteObserved(Now);
+
+	if (Step.IsLoad())
+	{
+		AsyncMixinStats::FStepTimeline Timeline;
+		Timeline.EnqueueTime = Step.GetEnqueueTime();
+		Timeline.IssueTime = Step.GetIssueTime();
+		Timeline.CompleteTime = Step.GetCompleteTime();
+		Timeline.CallbackTime = Now;
+		AsyncMixinStats::RecordStepCallback(Owner, Owner->GetAsyncLoadingAccessKey(), Timeline);
+
+		UE_LOG(LogAsyncMixin, VeryVerbose, TEXT("[0x%X] Step timeline - Queued %.2fms, Loading %.2fms, Waiting %.2fms"), this,
+			(Timeline.IssueTime - Timeline.EnqueueTime) * 1000.0, (Timeline.CompleteTime - Timeline.IssueTime) * 1000.0, (Now - Timeline.CompleteTime) * 1000.0);
+	}
+
+	if (!bHasCalledBack && (SequenceStartTime > 0.0))
+	{
+		bHasCalledBack = true;
+		AsyncMixinStats::RecordFirstCallback(Owner, Owner->GetAsyncLoadingAccessKey(), SequenceStartTime, Now);
+	}
+
+	// Before the callback, it may release us from the owner.
+	if (Step.IsLoad() && FAsyncMixinAccessRecorder::IsEnabled())
+	{
+		TArray<FSoftObjectPath> CompletedPaths;
+		if (Step.GetBatch().IsValid())
+		{
+			CompletedPaths = Step.GetBatchPaths();
+		}
+		else
+		{
+			Step.GetStreamingHandle()->GetRequestedAssets(CompletedPaths);
+		}
+
+		FAsyncMixinAccessRecorder::Get().PrefetchAfter(Owner->GetAsyncLoadingAccessKey(), CompletedPaths);
+	}
+
+	// Made it in time, or already too late, either way the deadline has nothing left to do.
+	Step.ClearDeadline();
+
+	if (Step.HasMissedDeadline())
+	{
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step completed %.2fms after it was requested, past its deadline"), this, (Now - Step.GetEnqueueTime()) * 1000.0);
+	}
+
+	++CallbackDepth;
+	Step.ExecuteUserCallback();
+	--CallbackDepth;
+}
+
+void FAsyncMixin::FLoadingState::HandleMissedDeadline(FAsyncStep& Step)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAsyncMixin_HandleMissedDeadline);
+
+	if (Step.HasExecutedUserCallback())
+	{
+		return;
+	}
+
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Step missed its deadline (Calling Fallback)"), this);
+
+	AsyncMixinStats::RecordDeadlineMiss();
+
+	// The fallback may cancel or release us, same as a user callback.
+	TSharedRef<FLoadingState> KeepAlive = AsShared();
+
+	++CallbackDepth;
+	Step.ExecuteMissedDeadlineCallback();
+	--CallbackDepth;
+}
+
+void FAsyncMixin::FLoadingState::RetainCompletedStep(const FAsyncStep& Step) const
+{
+	if (Owner->GetAsyncLoadingRetentionPolicy() != EAsyncMixinRetentionPolicy::KeepResidentUntilEvicted)
+	{
+		return;
+	}
+
+	if (Step.GetStreamingHandle().IsValid())
+	{
+		FAsyncMixinHandleCache::Get().Retain(Step.GetStreamingHandle());
+	}
+	else if (Step.GetBatch().IsValid())
+	{
+		// Only keep this step's own paths, the rest of the batch belongs to other mix-ins.
+		FAsyncMixinHandleCache::Get().Retain(Step.GetBatch()->GetHandle(), Step.GetBatchPaths());
+	}
+}
+
+void FAsyncMixin::FLoadingState::CompleteAsyncLoading()
+{
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] CompleteAsyncLoading"), this);
+
+	if (SequenceStartTime > 0.0)
+	{
+		UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] Sequence took %.2fms"), this, (FPlatformTime::Seconds() - SequenceStartTime) * 1000.0);
+		SequenceStartTime = 0.0;
+	}
+
+	// Mark that we've completed loading.
+	if (bHasStarted)
+	{
+		bHasStarted = false;
+		Owner->OnFinishedLoading();
+	}
+
+	// It's unlikely but possible they started loading more stuff in the OnFinishedLoading callback,
+	// so double check that we're still actually done.
+	//
+	// NOTE: We don't delete ourselves from memory in use.  Doing things like
+	// pre-loading a bundle requires keeping the streaming handle alive.  So we're keeping
+	// things alive.
+	// 
+	// We won't destroy the memory but we need to cleanup anything that may be hanging on to
+	// captured scope, like completion handlers.
+	if (IsLoadingComplete())
+	{
+		if (!bPreloadedBundles && !IsLoadingInProgressOrPending())
+		{
+			// If we're all done loading or pending loading, we should clean up the memory we're using.
+			// go ahead and remove this loading state the owner mix-in allocated.
+			RequestDestroyThisMemory();
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncMixin::FLoadingState::FAsyncStepPool::~FAsyncStepPool()
+{
+	ensureMsgf(FreeSlots.Num() == Chunks.Num() * StepsPerChunk, TEXT("Steps must be freed before their pool is destroyed."));
+}
+
+template <typename... ArgTypes>
+FAsyncMixin::FLoadingState::FAsyncStep* FAsyncMixin::FLoadingState::FAsyncStepPool::Allocate(ArgTypes&&... Args)
+{
+	if (FreeSlots.Num() == 0)
+	{
+		FChunk* Chunk = Chunks.Add_GetRef(MakeUnique<FChunk>()).Get();
+
+		// Push in reverse so the slots are handed out in address order.
+		for (int32 SlotIndex = StepsPerChunk - 1; SlotIndex >= 0; --SlotIndex)
+		{
+			FreeSlots.Add(Chunk->Slots[SlotIndex].GetTypedPtr());
+		}
+	}
+
+	AsyncMixinStats::AddLiveSteps(1);
+
+	FAsyncStep* Slot = FreeSlots.Pop(/*bAllowShrinking*/false);
+	return new (Slot) FAsyncStep(Forward<ArgTypes>(Args)...);
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStepPool::Free(FAsyncStep* Step)
+{
+	AsyncMixinStats::AddLiveSteps(-1);
+
+	Step->~FAsyncStep();
+	FreeSlots.Add(Step);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncMixin::FLoadingState::FAsyncStep::FAsyncStep(const FSimpleDelegate& InUserCallback)
+	: UserCallback(InUserCallback)
+	, bIsBarrier(true)
+	, EnqueueTime(FPlatformTime::Seconds())
+{
+}
+
+FAsyncMixin::FLoadingState::FAsyncStep::FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FStreamableHandle>& InStreamingHandle, TAsyncLoadPriority InPriority)
+	: UserCallback(InUserCallback)
+	, Priority(InPriority)
+	, EnqueueTime(FPlatformTime::Seconds())
+	, StreamingHandle(InStreamingHandle)
+{
+}
+
+FAsyncMixin::FLoadingState::FAsyncStep::FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedRef<FAsyncMixinLoadBatch>& InBatch, TArray<FSoftObjectPath>&& InBatchPaths,
+                                                   TAsyncLoadPriority InPriority)
+	: UserCallback(InUserCallback)
+	, Priority(InPriority)
+	, EnqueueTime(FPlatformTime::Seconds())
+	, Batch(InBatch)
+	, BatchPaths(MoveTemp(InBatchPaths))
+{
+}
+
+FAsyncMixin::FLoadingState::FAsyncStep::FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FAsyncCondition>& InCondition)
+	: UserCallback(InUserCallback)
+	, bIsBarrier(true)
+	, EnqueueTime(FPlatformTime::Seconds())
+	, Condition(InCondition)
+{
+}
+
+FAsyncMixin::FLoadingState::FAsyncStep::~FAsyncStep()
+{
+	// The batch holds onto our paths while we're waiting on it.
+	ReleaseBatch();
+	ClearDeadline();
+
+	ensureMsgf(CoroutineAddress == nullptr, TEXT("Steps must resume or destroy their coroutine before they're freed."));
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::ReleaseBatch()
+{
+	if (Batch.IsValid())
+	{
+		Batch->RemoveWaiter(this);
+		Batch->ReleasePaths(BatchPaths);
+		Batch.Reset();
+	}
+}
+
+double FAsyncMixin::FLoadingState::FAsyncStep::GetIssueTime() const
+{
+	// Coalesced steps wait for the end of the frame, everything else is requested as soon as it's queued.
+	return Batch.IsValid() ? Batch->GetIssueTime() : EnqueueTime;
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::MarkCompleteObserved(double Time)
+{
+	if (CompleteTime == 0.0)
+	{
+		CompleteTime = Time;
+	}
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::SetDeadline(FLoadingState& State, const FAsyncLoadDeadline& Deadline)
+{
+	DeadlineState = &State;
+	DeadlineCallback = Deadline.OnMissed;
+	bMissedDeadline = false;
+
+	AsyncMixinStats::RecordDeadlineScheduled();
+	FAsyncMixinScheduler::Get().ScheduleDeadline(*this, EnqueueTime + Deadline.Seconds);
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::ClearDeadline()
+{
+	FAsyncMixinScheduler::UnscheduleDeadline(*this);
+	DeadlineCallback.Unbind();
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::ExecuteMissedDeadlineCallback()
+{
+	bMissedDeadline = true;
+
+	// Unbind before calling, the fallback is only ever called once.
+	FSimpleDelegate Callback = MoveTemp(DeadlineCallback);
+	DeadlineCallback.Unbind();
+	Callback.ExecuteIfBound();
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::ExecuteUserCallback()
+{
+	bHasExecutedUserCallback = true;
+
+	// Forget the coroutine before resuming it, it may run to completion and free its frame.
+	if (void* Coroutine = Exchange(CoroutineAddress, nullptr))
+	{
+		std::coroutine_handle<>::from_address(Coroutine).resume();
+		return;
+	}
+
+	UserCallback.ExecuteIfBound();
+	UserCallback.Unbind();
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::DestroySuspendedCoroutine()
+{
+	if (void* Coroutine = Exchange(CoroutineAddress, nullptr))
+	{
+		std::coroutine_handle<>::from_address(Coroutine).destroy();
+	}
+}
+
+bool FAsyncMixin::FLoadingState::FAsyncStep::IsComplete() const
+{
+	if (StreamingHandle.IsValid())
+	{
+		return StreamingHandle->HasLoadCompleted();
+	}
+	else if (Batch.IsValid())
+	{
+		return Batch->IsComplete(BatchPaths);
+	}
+	else if (Condition.IsValid())
+	{
+		return Condition->IsComplete();
+	}
+
+	return true;
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::SetPriority(TAsyncLoadPriority NewPriority)
+{
+	if (Priority == NewPriority)
+	{
+		return;
+	}
+
+	// Batches that haven't been issued yet move up the admission queue, or are submitted at the raised priority.  They
+	// are shared with other steps and only ever raised, the step follows its batch so the two never disagree.
+	if (Batch.IsValid() && !Batch->IsIssued())
+	{
+		FAsyncMixinAdmissionController::Get().Reprioritize(*Batch, NewPriority);
+		Priority = Batch->GetPriority();
+		return;
+	}
+
+	const TAsyncLoadPriority OldPriority = Priority;
+	Priority = NewPriority;
+
+	TArray<FSoftObjectPath> RequestedAssets;
+	if (StreamingHandle.IsValid() && StreamingHandle->IsLoadingInProgress())
+	{
+		StreamingHandle->GetRequestedAssets(RequestedAssets);
+	}
+	else if (Batch.IsValid() && Batch->IsIssued() && !IsComplete())
+	{
+		RequestedAssets = BatchPaths;
+	}
+
+	// The package loader can only raise a request's priority, and each extra request pins its package until it loads.
+	// Lowering is recorded on the step for the loads it makes from now on, the one in flight keeps its priority.
+	if (NewPriority <= OldPriority)
+	{
+		return;
+	}
+
+	// Streamable handles have no way to change their priority once requested, but requesting a package that's already
+	// in flight again with a higher priority bumps the existing request in the package loader.
+	for (const FSoftObjectPath& RequestedAsset : RequestedAssets)
+	{
+		if (RequestedAsset.ResolveObject() == nullptr)
+		{
+			// Tracked, canceling the step can't take the request back from the package loader.  Skipped if the package
+			// already has a request at this priority or higher.
+			AsyncMixinCancellation::RequestPackagePriority(RequestedAsset.GetLongPackageFName(), NewPriority);
+		}
+	}
+}
+
+void FAsyncMixin::FLoadingState::FAsyncStep::Cancel()
+{
+	if (StreamingHandle.IsValid())
+	{
+		StreamingHandle->BindCompleteDelegate(FSimpleDelegate());
+
+		// Stop the load if nothing else wants it, rather than letting it compete with the loads we still need.
+		AsyncMixinCancellation::ReleaseHandle(StreamingHandle);
+	}
+	else if (Batch.IsValid())
+	{
+		ReleaseBatch();
+	}
+	else if (Condition.IsValid())
+	{
+		// Conditions can be shared, make sure this one doesn't call back into a state that's been reused.
+		Condition->CompletionDelegate.Unbind();
+		Condition.Reset();
+	}
+
+	ResidentObjects.Reset();
+	ClearDeadline();
+	bIsCompletionDelegateBound = false;
+}
+
+bool FAsyncMixin::FLoadingState::FAsyncStep::BindCompleteDelegate(const FSimpleDelegate& NewDelegate)
+{
+	if (IsComplete())
+	{
+		// Too Late!
+		return false;
+	}
+
+	if (StreamingHandle.IsValid())
+	{
+		StreamingHandle->BindCompleteDelegate(NewDelegate);
+	}
+	else if (Batch.IsValid())
+	{
+		Batch->AddWaiter(this, BatchPaths, NewDelegate);
+	}
+	else if (Condition)
+	{
+		Condition->BindCompleteDelegate(NewDelegate);
+	}
+
+	bIsCompletionDelegateBound = true;
+
+	return true;
+}
+
+bool FAsyncMixin::FLoadingState::FAsyncStep::IsCompleteDelegateBound() const
+{
+	return bIsCompletionDelegateBound;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncMixinRequestQueue::FAsyncMixinRequestQueue(FAsyncMixin& InOwner)
+	: Owner(&InOwner)
+{
+}
+
+void FAsyncMixinRequestQueue::AsyncLoad(const FSoftObjectPath& SoftObjectPath, TFunction<void()>&& Callback, TAsyncLoadPriority Priority)
+{
+	AsyncLoad(TArray<FSoftObjectPath>{ SoftObjectPath }, MoveTemp(Callback), Priority);
+}
+
+void FAsyncMixinRequestQueue::AsyncLoad(TArray<FSoftObjectPath> SoftObjectPaths, TFunction<void()>&& Callback, TAsyncLoadPriority Priority)
+{
+	FRequest Request;
+	Request.SoftObjectPaths = MoveTemp(SoftObjectPaths);
+	Request.Callback = MoveTemp(Callback);
+	Request.Priority = Priority;
+	Enqueue(MoveTemp(Request));
+}
+
+void FAsyncMixinRequestQueue::AsyncPreloadPrimaryAssetsAndBundles(TArray<FPrimaryAssetId> AssetIds, TArray<FName> LoadBundles, TFunction<void()>&& Callback,
+                                                                  TAsyncLoadPriority Priority)
+{
+	FRequest Request;
+	Request.AssetIds = MoveTemp(AssetIds);
+	Request.LoadBundles = MoveTemp(LoadBundles);
+	Request.Callback = MoveTemp(Callback);
+	Request.Priority = Priority;
+	Request.bPreload = true;
+	Enqueue(MoveTemp(Request));
+}
+
+void FAsyncMixinRequestQueue::Enqueue(FRequest&& Request)
+{
+	Requests.Enqueue(MoveTemp(Request));
+
+	// Only the push that finds the queue clean puts it on the scheduler's list.
+	if (!bQueuedForDrain.exchange(true))
+	{
+		FAsyncMixinScheduler::Get().ScheduleDrain(AsShared());
+	}
+}
+
+void FAsyncMixinRequestQueue::Drain()
+{
+	check(IsInGameThread());
+
+	// Clear the flag first, anything pushed from here on puts the queue back on the scheduler's list.
+	bQueuedForDrain = false;
+
+	bool bQueuedAny = false;
+
+	FRequest Request;
+	while (Requests.Dequeue(Request))
+	{
+		// Requests that arrive after the owner is gone are dropped, destroying their callbacks here on the game thread.
+		if (Owner == nullptr)
+		{
+			continue;
+		}
+
+		FSimpleDelegate Callback = Request.Callback ? FSimpleDelegate::CreateLambda(MoveTemp(Request.Callback)) : FSimpleDelegate();
+
+		if (Request.bPreload)
+		{
+			Owner->AsyncPreloadPrimaryAssetsAndBundles(Request.AssetIds, Request.LoadBundles, Callback, Request.Priority);
+		}
+		else
+		{
+			// Already a tick late, don't hold it back another one for the coalescer.
+			Owner->GetLoadingState().AsyncLoadNow(MoveTemp(Request.SoftObjectPaths), Callback, Request.Priority);
+		}
+
+		bQueuedAny = true;
+	}
+
+	// Nobody on the game thread knows these requests exist, start them rather than waiting for the next frame.
+	if (bQueuedAny && (Owner != nullptr))
+	{
+		Owner->StartAsyncLoading();
+	}
+}
+
+void FAsyncMixinRequestQueue::DetachFromOwner()
+{
+	check(IsInGameThread());
+	Owner = nullptr;
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncCondition::FAsyncCondition()
+	: PollingPolicy(FAsyncConditionPollingPolicy::SignalOnly())
+	, bWaitForSignal(true)
+{
+}
+
+FAsyncCondition::FAsyncCondition(const FAsyncConditionDelegate& Condition, const FAsyncConditionPollingPolicy& InPollingPolicy)
+	: UserCondition(Condition)
+	, PollingPolicy(InPollingPolicy)
+{
+}
+
+FAsyncCondition::FAsyncCondition(TFunction<EAsyncConditionResult()>&& Condition, const FAsyncConditionPollingPolicy& InPollingPolicy)
+	: UserCondition(FAsyncConditionDelegate::CreateLambda([UserFunction = MoveTemp(Condition)]() mutable { return UserFunction(); }))
+	, PollingPolicy(InPollingPolicy)
+{
+}
+
+FAsyncCondition::~FAsyncCondition()
+{
+	if (RepeatHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(-1);
+		FTSTicker::GetCoreTicker().RemoveTicker(RepeatHandle);
+	}
+}
+
+bool FAsyncCondition::IsComplete() const
+{
+	if (bCompleted)
+	{
+		return true;
+	}
+
+	if (UserCondition.IsBound())
+	{
+		const EAsyncConditionResult Result = UserCondition.Execute();
+		return Result == EAsyncConditionResult::Complete;
+	}
+
+	return !bWaitForSignal;
+}
+
+bool FAsyncCondition::BindCompleteDelegate(const FSimpleDelegate& NewDelegate)
+{
+	if (IsComplete())
+	{
+		// Already Complete
+		return false;
+	}
+
+	CompletionDelegate = NewDelegate;
+
+	if (!RepeatHandle.IsValid() && PollingPolicy.bPoll && UserCondition.IsBound())
+	{
+		SchedulePoll(PollingPolicy.InitialInterval);
+	}
+
+	return true;
+}
+
+void FAsyncCondition::Signal()
+{
+	check(IsInGameThread());
+
+	if (bCompleted)
+	{
+		return;
+	}
+
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncCondition::Signal"), this);
+
+	if (UserCondition.IsBound() && (UserCondition.Execute() != EAsyncConditionResult::Complete))
+	{
+		return;
+	}
+
+	CompleteCondition();
+}
+
+void FAsyncCondition::SchedulePoll(float Interval)
+{
+	CurrentPollInterval = Interval;
+
+	// Backing off replaces the ticker, the old one is removed by returning false.
+	if (!RepeatHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(1);
+	}
+	RepeatHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FAsyncCondition::TryToContinue), Interval);
+}
+
+void FAsyncCondition::CompleteCondition()
+{
+	bCompleted = true;
+
+	if (RepeatHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(-1);
+		FTSTicker::GetCoreTicker().RemoveTicker(RepeatHandle);
+		RepeatHandle.Reset();
+	}
+
+	UserCondition.Unbind();
+
+	// Copy in case the completion callback re-binds us.
+	const FSimpleDelegate CompletionDelegateCopy = CompletionDelegate;
+	CompletionDelegate.Unbind();
+	CompletionDelegateCopy.ExecuteIfBound();
+}
+
+bool FAsyncCondition::TryToContinue(float)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncCondition_TryToContinue);
+
+	UE_LOG(LogAsyncMixin, Verbose, TEXT("[0x%X] AsyncCondition::TryToContinue"), this);
+
+	if (UserCondition.IsBound())
+	{
+		const EAsyncConditionResult Result = UserCondition.Execute();
+
+		switch (Result)
+		{
+		case EAsyncConditionResult::TryAgain:
+			if (PollingPolicy.BackoffMultiplier > 1.0f)
+			{
+				// The ticker delay is fixed when it's added, so back off by re-adding it with the longer interval.
+				const float NextInterval = FMath::Min(CurrentPollInterval * PollingPolicy.BackoffMultiplier, PollingPolicy.MaxInterval);
+				if (NextInterval > CurrentPollInterval)
+				{
+					SchedulePoll(NextInterval);
+					return false;
+				}
+			}
+			return true;
+		case EAsyncConditionResult::Complete:
+			// Returning false removes the ticker for us.
+			AsyncMixinStats::AddActiveTickers(-1);
+			RepeatHandle.Reset();
+			CompleteCondition();
+			break;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,311 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinAccessRecorder.h"
+
+#include "AsyncMixinRequestCoalescer.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Stats/Stats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinAccessRecorder, Log, All);
+
+namespace AsyncMixinCVars
+{
+	static bool bPrefetchEnable = false;
+	static FAutoConsoleVariableRef CVarPrefetchEnable(
+		TEXT("AsyncMixin.Prefetch.Enable"),
+		bPrefetchEnable,
+		TEXT("Record the order mix-ins request their paths in, and prefetch the paths likely to be requested next."));
+
+	static float PrefetchMinProbability = 0.3f;
+	static FAutoConsoleVariableRef CVarPrefetchMinProbability(
+		TEXT("AsyncMixin.Prefetch.MinProbability"),
+		PrefetchMinProbability,
+		TEXT("How often a path has to have followed the completed one to be prefetched, from 0 to 1."));
+
+	static int32 PrefetchMaxPerLoad = 2;
+	static FAutoConsoleVariableRef CVarPrefetchMaxPerLoad(
+		TEXT("AsyncMixin.Prefetch.MaxPerLoad"),
+		PrefetchMaxPerLoad,
+		TEXT("Maximum number of paths prefetched after each completed path."));
+
+	static int32 PrefetchMaxInFlight = 16;
+	static FAutoConsoleVariableRef CVarPrefetchMaxInFlight(
+		TEXT("AsyncMixin.Prefetch.MaxInFlight"),
+		PrefetchMaxInFlight,
+		TEXT("Maximum number of prefetches kept alive, the oldest one is dropped (and canceled if it's still loading) to make room."));
+
+	static int32 PrefetchPriority = FStreamableManager::DefaultAsyncLoadPriority;
+	static FAutoConsoleVariableRef CVarPrefetchPriority(
+		TEXT("AsyncMixin.Prefetch.Priority"),
+		PrefetchPriority,
+		TEXT("Async load priority of prefetches, below AsyncLoadHighPriority so they're admitted after the loads mix-ins are waiting on."));
+
+	static FAutoConsoleCommand CmdAccessRecorderSave(
+		TEXT("AsyncMixin.Prefetch.Save"),
+		TEXT("Saves the AsyncMixin access pattern table now, rather than waiting for shutdown."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FAsyncMixinAccessRecorder::Get().Save();
+		}));
+
+	static FAutoConsoleCommand CmdAccessRecorderReset(
+		TEXT("AsyncMixin.Prefetch.Reset"),
+		TEXT("Forgets the recorded AsyncMixin access patterns, the next save overwrites the table on disk."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FAsyncMixinAccessRecorder::Get().Reset();
+		}));
+}
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Prefetched Paths"), STAT_AsyncMixin_PrefetchedPaths, STATGROUP_AsyncMixin);
+
+FAsyncMixinAccessRecorder& FAsyncMixinAccessRecorder::Get()
+{
+	static FAsyncMixinAccessRecorder Instance;
+	return Instance;
+}
+
+bool FAsyncMixinAccessRecorder::IsEnabled()
+{
+	return AsyncMixinCVars::bPrefetchEnable;
+}
+
+FString FAsyncMixinAccessRecorder::GetSavePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("AsyncMixin") / TEXT("AccessPatterns.bin");
+}
+
+void FAsyncMixinAccessRecorder::RecordAccess(FName OwnerKey, const TArray<FSoftObjectPath>& SoftObjectPaths)
+{
+	check(IsInGameThread());
+
+	if (OwnerKey.IsNone() || (SoftObjectPaths.Num() == 0))
+	{
+		return;
+	}
+
+	FSoftObjectPath& LastPath = LastPathByOwner.FindOrAdd(OwnerKey);
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		if (!SoftObjectPath.IsNull() && (SoftObjectPath != LastPath))
+		{
+			if (!LastPath.IsNull())
+			{
+				AddTransition(OwnerKey, LastPath, SoftObjectPath);
+			}
+			LastPath = SoftObjectPath;
+		}
+	}
+}
+
+void FAsyncMixinAccessRecorder::AddTransition(FName OwnerKey, const FSoftObjectPath& From, const FSoftObjectPath& To)
+{
+	FTransitions& Entry = Transitions.FindOrAdd(FTransitionKey(OwnerKey, From));
+	++Entry.TotalCount;
+	bDirty = true;
+
+	FSuccessor* Successor = Entry.Successors.FindByPredicate([&To](const FSuccessor& Candidate) { return Candidate.SoftObjectPath == To; });
+	if (Successor == nullptr)
+	{
+		if (Entry.Successors.Num() < MaxSuccessors)
+		{
+			Successor = &Entry.Successors.AddDefaulted_GetRef();
+		}
+		else
+		{
+			// Replace the least frequent one.  The newcomer starts from scratch, inheriting the old count would let a single
+			// visit clear MinProbability.  The old visits stay in TotalCount, they did happen.
+			Successor = &Entry.Successors[0];
+			for (FSuccessor& Candidate : Entry.Successors)
+			{
+				if (Candidate.Count < Successor->Count)
+				{
+					Successor = &Candidate;
+				}
+			}
+		}
+		Successor->SoftObjectPath = To;
+		Successor->Count = 0;
+	}
+
+	++Successor->Count;
+}
+
+void FAsyncMixinAccessRecorder::PrefetchAfter(FName OwnerKey, const TArray<FSoftObjectPath>& CompletedPaths)
+{
+	check(IsInGameThread());
+
+	if (OwnerKey.IsNone() || (AsyncMixinCVars::PrefetchMaxInFlight <= 0))
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> PathsToPrefetch;
+	for (const FSoftObjectPath& CompletedPath : CompletedPaths)
+	{
+		const FTransitions* Entry = Transitions.Find(FTransitionKey(OwnerKey, CompletedPath));
+		if ((Entry == nullptr) || (Entry->TotalCount == 0))
+		{
+			continue;
+		}
+
+		TArray<const FSuccessor*, TInlineAllocator<MaxSuccessors>> Likely;
+		for (const FSuccessor& Successor : Entry->Successors)
+		{
+			if ((float(Successor.Count) / Entry->TotalCount >= AsyncMixinCVars::PrefetchMinProbability) && !FAsyncMixinRequestCoalescer::IsFullyLoaded(Successor.SoftObjectPath))
+			{
+				Likely.Add(&Successor);
+			}
+		}
+
+		Likely.Sort([](const FSuccessor& A, const FSuccessor& B) { return A.Count > B.Count; });
+
+		for (int32 Index = 0; Index < FMath::Min(Likely.Num(), AsyncMixinCVars::PrefetchMaxPerLoad); ++Index)
+		{
+			PathsToPrefetch.AddUnique(Likely[Index]->SoftObjectPath);
+		}
+	}
+
+	if (PathsToPrefetch.Num() == 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogAsyncMixinAccessRecorder, Verbose, TEXT("Prefetching %d paths for '%s'"), PathsToPrefetch.Num(), *OwnerKey.ToString());
+	INC_DWORD_STAT_BY(STAT_AsyncMixin_PrefetchedPaths, PathsToPrefetch.Num());
+
+	while (Prefetches.Num() >= AsyncMixinCVars::PrefetchMaxInFlight)
+	{
+		Prefetches.RemoveAt(0, 1, /*bAllowShrinking*/false);
+	}
+
+	Prefetches.Add(FAsyncMixinRequestCoalescer::Get().RequestNow(PathsToPrefetch, AsyncMixinCVars::PrefetchPriority));
+}
+
+void FAsyncMixinAccessRecorder::Load()
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetSavePath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Ar(Bytes);
+
+	uint32 Version = 0;
+	Ar << Version;
+	if (Version != FileVersion)
+	{
+		UE_LOG(LogAsyncMixinAccessRecorder, Log, TEXT("Ignoring access patterns saved with version %u"), Version);
+		return;
+	}
+
+	int32 NumEntries = 0;
+	Ar << NumEntries;
+
+	// Every entry takes at least the lengths of its two strings and its successor count, don't trust a count that
+	// couldn't fit in what's left of the file before reserving for it.
+	constexpr int64 MinEntryBytes = 3 * sizeof(int32);
+	if (Ar.IsError() || (NumEntries < 0) || (NumEntries > (Ar.TotalSize() - Ar.Tell()) / MinEntryBytes))
+	{
+		UE_LOG(LogAsyncMixinAccessRecorder, Warning, TEXT("Ignoring access patterns in '%s', %d entries can't fit in the file"), *GetSavePath(), NumEntries);
+		return;
+	}
+
+	TMap<FTransitionKey, FTransitions> LoadedTransitions;
+	LoadedTransitions.Reserve(NumEntries);
+
+	for (int32 EntryIndex = 0; (EntryIndex < NumEntries) && !Ar.IsError(); ++EntryIndex)
+	{
+		FString OwnerKey;
+		FString From;
+		int32 NumSuccessors = 0;
+		Ar << OwnerKey << From << NumSuccessors;
+
+		// A successor is at least the length of its path and its count.
+		constexpr int64 MinSuccessorBytes = sizeof(int32) + sizeof(uint32);
+		if ((NumSuccessors < 0) || (NumSuccessors > (Ar.TotalSize() - Ar.Tell()) / MinSuccessorBytes))
+		{
+			Ar.SetError();
+			break;
+		}
+
+		FTransitions& Entry = LoadedTransitions.Add(FTransitionKey(FName(*OwnerKey), FSoftObjectPath(From)));
+		for (int32 SuccessorIndex = 0; (SuccessorIndex < NumSuccessors) && !Ar.IsError(); ++SuccessorIndex)
+		{
+			FString To;
+			uint32 Count = 0;
+			Ar << To << Count;
+
+			if (Entry.Successors.Num() < MaxSuccessors)
+			{
+				Entry.Successors.Add(FSuccessor{ FSoftObjectPath(To), Count });
+				Entry.TotalCount += Count;
+			}
+		}
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogAsyncMixinAccessRecorder, Warning, TEXT("Failed to read access patterns from '%s'"), *GetSavePath());
+		return;
+	}
+
+	Transitions = MoveTemp(LoadedTransitions);
+	bDirty = false;
+
+	UE_LOG(LogAsyncMixinAccessRecorder, Log, TEXT("Loaded %d access pattern entries"), Transitions.Num());
+}
+
+void FAsyncMixinAccessRecorder::Save()
+{
+	if (!bDirty)
+	{
+		return;
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+
+	uint32 Version = FileVersion;
+	int32 NumEntries = Transitions.Num();
+	Ar << Version << NumEntries;
+
+	for (const TPair<FTransitionKey, FTransitions>& Pair : Transitions)
+	{
+		FString OwnerKey = Pair.Key.Key.ToString();
+		FString From = Pair.Key.Value.ToString();
+		int32 NumSuccessors = Pair.Value.Successors.Num();
+		Ar << OwnerKey << From << NumSuccessors;
+
+		for (const FSuccessor& Successor : Pair.Value.Successors)
+		{
+			FString To = Successor.SoftObjectPath.ToString();
+			uint32 Count = Successor.Count;
+			Ar << To << Count;
+		}
+	}
+
+	if (FFileHelper::SaveArrayToFile(Bytes, *GetSavePath()))
+	{
+		bDirty = false;
+		UE_LOG(LogAsyncMixinAccessRecorder, Log, TEXT("Saved %d access pattern entries"), Transitions.Num());
+	}
+	else
+	{
+		UE_LOG(LogAsyncMixinAccessRecorder, Warning, TEXT("Failed to save access patterns to '%s'"), *GetSavePath());
+	}
+}
+
+void FAsyncMixinAccessRecorder::Reset()
+{
+	Transitions.Reset();
+	LastPathByOwner.Reset();
+	Prefetches.Reset();
+	bDirty = true;
+}
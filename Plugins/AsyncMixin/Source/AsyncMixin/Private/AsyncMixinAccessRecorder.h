@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Templates/SharedPointer.h"
+#include "UObject/SoftObjectPath.h"
+
+class FAsyncMixinLoadBatch;
+
+/**
+ * Records the order mix-ins request their paths in, per owner key (see FAsyncMixin::GetAsyncLoadingAccessKey), as a
+ * table of how often each path was followed by each other path.  When a load completes the most likely next paths are
+ * prefetched at a low priority, through the admission controller, so they never hold back the loads that are wanted now.
+ *
+ * The table is loaded from Saved/AsyncMixin/AccessPatterns.bin at startup and saved back on shutdown.  Recording and
+ * prefetching are off unless AsyncMixin.Prefetch.Enable is set.
+ *
+ * Game thread only.
+ */
+class FAsyncMixinAccessRecorder
+{
+public:
+	static FAsyncMixinAccessRecorder& Get();
+
+	static bool IsEnabled();
+
+	/** Records that the owner requested the paths, in order, after whatever it requested last */
+	void RecordAccess(FName OwnerKey, const TArray<FSoftObjectPath>& SoftObjectPaths);
+
+	/** Prefetches the paths the owner is likely to request after the ones that just completed */
+	void PrefetchAfter(FName OwnerKey, const TArray<FSoftObjectPath>& CompletedPaths);
+
+	/** Loads the table saved by a previous session, replacing what has been recorded so far */
+	void Load();
+
+	/** Saves the table if anything was recorded since it was loaded or last saved */
+	void Save();
+
+	/** Forgets the recorded table and releases the prefetches */
+	void Reset();
+
+private:
+	// Successors kept per path, the least frequent one is replaced by a new one, which starts counting from one
+	static constexpr int32 MaxSuccessors = 8;
+	static constexpr uint32 FileVersion = 1;
+
+	struct FSuccessor
+	{
+		FSoftObjectPath SoftObjectPath;
+		uint32 Count = 0;
+	};
+
+	struct FTransitions
+	{
+		TArray<FSuccessor, TInlineAllocator<MaxSuccessors>> Successors;
+		uint32 TotalCount = 0;
+	};
+
+	using FTransitionKey = TPair<FName, FSoftObjectPath>;
+
+	static FString GetSavePath();
+	void AddTransition(FName OwnerKey, const FSoftObjectPath& From, const FSoftObjectPath& To);
+
+	TMap<FTransitionKey, FTransitions> Transitions;
+	TMap<FName, FSoftObjectPath> LastPathByOwner;
+
+	// Oldest first, dropping a prefetch cancels it if it's still loading
+	TArray<TSharedRef<FAsyncMixinLoadBatch>> Prefetches;
+
+	bool bDirty = false;
+};
@@ -0,0 +1,243 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinActorPool.h"
+
+#include "AsyncMixinStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AsyncMixinActorPool)
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinActorPool, Log, All);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actors"), STAT_AsyncMixin_PooledActors, STATGROUP_AsyncMixin);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Actor Misses"), STAT_AsyncMixin_PooledActorMisses, STATGROUP_AsyncMixin);
+
+namespace AsyncMixinCVars
+{
+	static float ActorPoolPrewarmBudgetMs = 1.0f;
+	static FAutoConsoleVariableRef CVarActorPoolPrewarmBudgetMs(
+		TEXT("AsyncMixin.ActorPool.PrewarmBudgetMs"),
+		ActorPoolPrewarmBudgetMs,
+		TEXT("Milliseconds per frame spent constructing pooled actors, at least one is constructed each frame while any are missing."));
+}
+
+UAsyncMixinActorPool* UAsyncMixinActorPool::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<UAsyncMixinActorPool>() : nullptr;
+}
+
+bool UAsyncMixinActorPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return (WorldType == EWorldType::Game) || (WorldType == EWorldType::PIE);
+}
+
+void UAsyncMixinActorPool::Prewarm(TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	if ((ActorClass == nullptr) || (Count <= 0) || ActorClass->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+	{
+		return;
+	}
+
+	FAsyncMixinPooledActors& Pool = Pools.FindOrAdd(ActorClass);
+	Pool.TargetCount = FMath::Max(Pool.TargetCount, Count);
+
+	UE_LOG(LogAsyncMixinActorPool, Verbose, TEXT("Prewarming %d instances of %s, %d pooled"), Pool.TargetCount, *ActorClass->GetName(), Pool.Actors.Num());
+}
+
+bool UAsyncMixinActorPool::IsPrewarming(TSubclassOf<AActor> ActorClass) const
+{
+	const FAsyncMixinPooledActors* Pool = Pools.Find(ActorClass);
+	return Pool && (Pool->Actors.Num() < Pool->TargetCount);
+}
+
+int32 UAsyncMixinActorPool::GetNumPooled(TSubclassOf<AActor> ActorClass) const
+{
+	const FAsyncMixinPooledActors* Pool = Pools.Find(ActorClass);
+	return Pool ? Pool->Actors.Num() : 0;
+}
+
+AActor* UAsyncMixinActorPool::ConstructPooledActor(TSubclassOf<AActor> ActorClass)
+{
+	// Well inside the world bounds and above any kill Z, so nothing destroys it while it waits.
+	static const FTransform ParkingTransform(FVector(0.0, 0.0, 1000000.0));
+
+	// Finished now, so the construction script, component registration and BeginPlay are paid for while prewarming.
+	AActor* Actor = GetWorld()->SpawnActorDeferred<AActor>(ActorClass, ParkingTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Actor)
+	{
+		Actor->SetActorHiddenInGame(true);
+		Actor->SetActorEnableCollision(false);
+		Actor->PrimaryActorTick.bStartWithTickEnabled = false;
+		Actor->FinishSpawning(ParkingTransform);
+
+		// BeginPlay may have turned them back on.
+		Actor->SetActorHiddenInGame(true);
+		Actor->SetActorEnableCollision(false);
+		Actor->SetActorTickEnabled(false);
+	}
+
+	return IsValid(Actor) ? Actor : nullptr;
+}
+
+AActor* UAsyncMixinActorPool::SpawnActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, AActor* Owner, APawn* Instigator,
+                                         ESpawnActorCollisionHandlingMethod CollisionHandling)
+{
+	if (ActorClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	AActor* Actor = nullptr;
+	FAsyncMixinPooledActors* Pool = Pools.Find(ActorClass);
+	if (Pool)
+	{
+		// Pooled actors may have been destroyed from under us, e.g. by a level transition.
+		while ((Actor == nullptr) && (Pool->Actors.Num() > 0))
+		{
+			Actor = Pool->Actors.Pop(/*bAllowShrinking*/false);
+			DEC_DWORD_STAT(STAT_AsyncMixin_PooledActors);
+
+			if (!IsValid(Actor))
+			{
+				Actor = nullptr;
+			}
+		}
+	}
+
+	if (Actor == nullptr)
+	{
+		INC_DWORD_STAT(STAT_AsyncMixin_PooledActorMisses);
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = Owner;
+		SpawnParameters.Instigator = Instigator;
+		SpawnParameters.SpawnCollisionHandlingOverride = CollisionHandling;
+		return GetWorld()->SpawnActor(ActorClass, &Transform, SpawnParameters);
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_UAsyncMixinActorPool_Acquire);
+
+	const AActor* DefaultActor = ActorClass->GetDefaultObject<AActor>();
+
+	// The actor has already spawned, apply the collision handling the way SpawnActor would have.
+	if (CollisionHandling == ESpawnActorCollisionHandlingMethod::Undefined)
+	{
+		CollisionHandling = DefaultActor->SpawnCollisionHandlingMethod;
+	}
+
+	FVector Location = Transform.GetLocation();
+	FRotator Rotation = Transform.Rotator();
+	if (DefaultActor->GetActorEnableCollision() && (CollisionHandling != ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
+	{
+		// The encroachment checks only look at components that collide.
+		Actor->SetActorEnableCollision(true);
+
+		const bool bAdjust = (CollisionHandling == ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn)
+			|| (CollisionHandling == ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding);
+		const bool bFits = bAdjust
+			? GetWorld()->FindTeleportSpot(Actor, Location, Rotation)
+			: !GetWorld()->EncroachingBlockingGeometry(Actor, Location, Rotation);
+
+		if (!bFits && (CollisionHandling != ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn))
+		{
+			// Still good for the next one.
+			Actor->SetActorEnableCollision(false);
+			Pool->Actors.Push(Actor);
+			INC_DWORD_STAT(STAT_AsyncMixin_PooledActors);
+			return nullptr;
+		}
+	}
+
+	Actor->SetActorTransform(FTransform(Rotation, Location, Transform.GetScale3D()), /*bSweep*/false, nullptr, ETeleportType::ResetPhysics);
+	Actor->SetOwner(Owner);
+	Actor->SetInstigator(Instigator);
+	Actor->SetActorHiddenInGame(DefaultActor->IsHidden());
+	Actor->SetActorEnableCollision(DefaultActor->GetActorEnableCollision());
+	Actor->SetActorTickEnabled(DefaultActor->PrimaryActorTick.bStartWithTickEnabled);
+
+	return Actor;
+}
+
+void UAsyncMixinActorPool::Drain(TSubclassOf<AActor> ActorClass)
+{
+	FAsyncMixinPooledActors Pool;
+	if (Pools.RemoveAndCopyValue(ActorClass, Pool))
+	{
+		for (AActor* Actor : Pool.Actors)
+		{
+			DEC_DWORD_STAT(STAT_AsyncMixin_PooledActors);
+
+			if (IsValid(Actor))
+			{
+				Actor->Destroy();
+			}
+		}
+	}
+}
+
+void UAsyncMixinActorPool::Deinitialize()
+{
+	TArray<TSubclassOf<AActor>> ActorClasses;
+	Pools.GenerateKeyArray(ActorClasses);
+
+	for (const TSubclassOf<AActor>& ActorClass : ActorClasses)
+	{
+		Drain(ActorClass);
+	}
+
+	Super::Deinitialize();
+}
+
+void UAsyncMixinActorPool::Tick(float DeltaTime)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = FMath::Max(AsyncMixinCVars::ActorPoolPrewarmBudgetMs, 0.0f) / 1000.0;
+
+	// BeginPlay of a pooled actor can prewarm or drain other classes, which adds to or removes from the map, so the pool is
+	// looked up again after every actor rather than held onto.  Classes added along the way are prewarmed next frame.
+	TArray<TSubclassOf<AActor>> ActorClasses;
+	Pools.GenerateKeyArray(ActorClasses);
+
+	for (const TSubclassOf<AActor>& ActorClass : ActorClasses)
+	{
+		FAsyncMixinPooledActors* Pool = Pools.Find(ActorClass);
+		while (Pool && (Pool->Actors.Num() < Pool->TargetCount))
+		{
+			AActor* Actor = ConstructPooledActor(ActorClass);
+
+			Pool = Pools.Find(ActorClass);
+			if (Pool == nullptr)
+			{
+				// Drained while it was spawning, it isn't wanted anymore.
+				if (Actor)
+				{
+					Actor->Destroy();
+				}
+				break;
+			}
+
+			if (Actor == nullptr)
+			{
+				UE_LOG(LogAsyncMixinActorPool, Warning, TEXT("Failed to construct a pooled %s, giving up on prewarming it"), *GetNameSafe(ActorClass));
+				Pool->TargetCount = Pool->Actors.Num();
+				break;
+			}
+
+			Pool->Actors.Add(Actor);
+			INC_DWORD_STAT(STAT_AsyncMixin_PooledActors);
+
+			if (FPlatformTime::Seconds() - StartTime >= Budget)
+			{
+				return;
+			}
+		}
+	}
+}
+
+TStatId UAsyncMixinActorPool::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAsyncMixinActorPool, STATGROUP_Tickables);
+}
@@ -0,0 +1,203 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinAdmission.h"
+
+#include "AsyncMixinCancellation.h"
+#include "AsyncMixinRequestCoalescer.h"
+#include "AsyncMixinStats.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinAdmission, Log, All);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued Batches"), STAT_AsyncMixin_QueuedBatches, STATGROUP_AsyncMixin);
+DECLARE_DWORD_COUNTER_STAT(TEXT("In-Flight Requests"), STAT_AsyncMixin_InFlightRequests, STATGROUP_AsyncMixin);
+DECLARE_MEMORY_STAT(TEXT("In-Flight Bytes (Disk)"), STAT_AsyncMixin_InFlightBytes, STATGROUP_AsyncMixin);
+
+namespace AsyncMixinCVars
+{
+	static int32 MaxInFlightRequests = 8;
+	static FAutoConsoleVariableRef CVarMaxInFlightRequests(
+		TEXT("AsyncMixin.Admission.MaxInFlightRequests"),
+		MaxInFlightRequests,
+		TEXT("Maximum number of AsyncMixin streamable requests loading at once, the rest wait in priority order.  0 is unlimited."));
+
+	static int32 MaxInFlightMB = 32;
+	static FAutoConsoleVariableRef CVarMaxInFlightMB(
+		TEXT("AsyncMixin.Admission.MaxInFlightMB"),
+		MaxInFlightMB,
+		TEXT("Maximum package size on disk, in MB, the AsyncMixin streamable requests loading at once may add up to.  0 is unlimited."));
+}
+
+FAsyncMixinAdmissionController& FAsyncMixinAdmissionController::Get()
+{
+	static FAsyncMixinAdmissionController Instance;
+	return Instance;
+}
+
+static bool QueuedBatchPredicate(TAsyncLoadPriority PriorityA, uint64 SequenceA, TAsyncLoadPriority PriorityB, uint64 SequenceB)
+{
+	return (PriorityA != PriorityB) ? (PriorityA > PriorityB) : (SequenceA < SequenceB);
+}
+
+void FAsyncMixinAdmissionController::Submit(const TSharedRef<FAsyncMixinLoadBatch>& Batch)
+{
+	check(IsInGameThread());
+
+	QueuedBatches.HeapPush(FQueuedBatch{ Batch, Batch->Priority, NextSequence++ }, [](const FQueuedBatch& A, const FQueuedBatch& B)
+	{
+		return QueuedBatchPredicate(A.Priority, A.Sequence, B.Priority, B.Sequence);
+	});
+	SET_DWORD_STAT(STAT_AsyncMixin_QueuedBatches, QueuedBatches.Num());
+
+	TryAdmit();
+}
+
+void FAsyncMixinAdmissionController::Release(int64 Bytes)
+{
+	check(IsInGameThread());
+
+	--InFlightRequests;
+	InFlightBytes -= Bytes;
+	SET_DWORD_STAT(STAT_AsyncMixin_InFlightRequests, InFlightRequests);
+	SET_MEMORY_STAT(STAT_AsyncMixin_InFlightBytes, InFlightBytes);
+
+	// Requests are released from inside streamable callbacks and batch destructors, admit the next ones from a clean stack.
+	ScheduleAdmit();
+}
+
+void FAsyncMixinAdmissionController::Reprioritize(FAsyncMixinLoadBatch& Batch, TAsyncLoadPriority Priority)
+{
+	check(IsInGameThread());
+
+	if (Batch.bIssued || (Priority <= Batch.Priority))
+	{
+		return;
+	}
+
+	const TAsyncLoadPriority OldPriority = Batch.Priority;
+	Batch.Priority = Priority;
+
+	FQueuedBatch* Queued = QueuedBatches.FindByPredicate([&Batch](const FQueuedBatch& QueuedBatch) { return &QueuedBatch.Batch.Get() == &Batch; });
+	if (Queued == nullptr)
+	{
+		// Still in the coalescer, move it out of the old priority's slot so later requests at that priority don't join it.
+		FAsyncMixinRequestCoalescer::Get().Reprioritize(Batch, OldPriority);
+		return;
+	}
+
+	UE_LOG(LogAsyncMixinAdmission, Verbose, TEXT("Raising queued batch 0x%p from priority %d to %d"), &Batch, Queued->Priority, Priority);
+
+	Queued->Priority = Priority;
+	QueuedBatches.Heapify([](const FQueuedBatch& A, const FQueuedBatch& B)
+	{
+		return QueuedBatchPredicate(A.Priority, A.Sequence, B.Priority, B.Sequence);
+	});
+
+	// The new front may fit where the old one didn't, but the caller may be walking its steps, admit from a clean stack.
+	ScheduleAdmit();
+}
+
+void FAsyncMixinAdmissionController::ScheduleAdmit()
+{
+	if ((QueuedBatches.Num() > 0) && !AdmitTickerHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(1);
+		AdmitTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAsyncMixinAdmissionController::HandleAdmitTick));
+	}
+}
+
+void FAsyncMixinAdmissionController::Reset()
+{
+	if (AdmitTickerHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(-1);
+		FTSTicker::GetCoreTicker().RemoveTicker(AdmitTickerHandle);
+		AdmitTickerHandle.Reset();
+	}
+	QueuedBatches.Empty();
+	SET_DWORD_STAT(STAT_AsyncMixin_QueuedBatches, 0);
+}
+
+bool FAsyncMixinAdmissionController::HasBudgetFor(int64 Bytes) const
+{
+	if (InFlightRequests == 0)
+	{
+		return true;
+	}
+
+	if ((AsyncMixinCVars::MaxInFlightRequests > 0) && (InFlightRequests >= AsyncMixinCVars::MaxInFlightRequests))
+	{
+		return false;
+	}
+
+	if ((AsyncMixinCVars::MaxInFlightMB > 0) && (InFlightBytes + Bytes > int64(AsyncMixinCVars::MaxInFlightMB) * 1024 * 1024))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void FAsyncMixinAdmissionController::TryAdmit()
+{
+	if (bIsAdmitting)
+	{
+		return;
+	}
+
+	TGuardValue<bool> AdmittingGuard(bIsAdmitting, true);
+
+	while (QueuedBatches.Num() > 0)
+	{
+		FQueuedBatch& Front = QueuedBatches.HeapTop();
+		FAsyncMixinLoadBatch& Batch = *Front.Batch;
+
+		// Every step that wanted the batch has been canceled while it was waiting, it never costs anything.
+		const bool bCanceled = Front.Batch.IsUnique() || (Batch.PendingPaths.Num() == 0);
+
+		int64 Bytes = 0;
+		if (!bCanceled)
+		{
+			// Expanded once per batch, a batch held for budget is checked again every time something is released.
+			Bytes = AsyncMixinCancellation::GetUnloadedDiskSize(Batch.GetExpandedPaths());
+
+			if (!HasBudgetFor(Bytes))
+			{
+				UE_LOG(LogAsyncMixinAdmission, Verbose, TEXT("Holding %d batches, %d requests (%lld bytes) in flight"), QueuedBatches.Num(), InFlightRequests, InFlightBytes);
+				break;
+			}
+		}
+
+		FQueuedBatch Admitted = MoveTemp(Front);
+		QueuedBatches.HeapPopDiscard([](const FQueuedBatch& A, const FQueuedBatch& B)
+		{
+			return QueuedBatchPredicate(A.Priority, A.Sequence, B.Priority, B.Sequence);
+		}, /*bAllowShrinking*/false);
+		SET_DWORD_STAT(STAT_AsyncMixin_QueuedBatches, QueuedBatches.Num());
+
+		if (bCanceled)
+		{
+			continue;
+		}
+
+		// Count the request before issuing it, it may finish synchronously and release its budget straight away.
+		++InFlightRequests;
+		InFlightBytes += Bytes;
+		SET_DWORD_STAT(STAT_AsyncMixin_InFlightRequests, InFlightRequests);
+		SET_MEMORY_STAT(STAT_AsyncMixin_InFlightBytes, InFlightBytes);
+
+		Admitted.Batch->bHoldsAdmission = true;
+		Admitted.Batch->AdmittedBytes = Bytes;
+		Admitted.Batch->Issue();
+	}
+}
+
+bool FAsyncMixinAdmissionController::HandleAdmitTick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinAdmissionController_Admit);
+
+	AsyncMixinStats::AddActiveTickers(-1);
+	AdmitTickerHandle.Reset();
+	TryAdmit();
+	return false;
+}
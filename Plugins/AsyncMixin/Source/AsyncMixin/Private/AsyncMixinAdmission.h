@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "Templates/SharedPointer.h"
+
+class FAsyncMixinLoadBatch;
+
+/**
+ * Caps how many streamable requests the AsyncMixin layer has loading at once, and how many bytes they read between
+ * them.  Batches that don't fit are queued by priority, first come first served within a priority, and issued as
+ * earlier requests finish or are canceled.  A batch is always admitted if nothing else is in flight, so one that's over
+ * the byte budget on its own can't stall the queue.
+ *
+ * Game thread only.
+ */
+class FAsyncMixinAdmissionController
+{
+public:
+	static FAsyncMixinAdmissionController& Get();
+
+	/** Issues the batch now if there's budget for it, otherwise queues it behind the batches of the same or higher priority */
+	void Submit(const TSharedRef<FAsyncMixinLoadBatch>& Batch);
+
+	/** Returns the budget of a request that's no longer loading, queued batches are admitted on the next tick */
+	void Release(int64 Bytes);
+
+	/**
+	 * Raises the priority of a batch that hasn't been issued yet, moving it up the queue if it's already waiting in it,
+	 * or out of its old priority's slot in the coalescer if it's still pending there.
+	 * Like the package loader, priorities are only ever raised, the batch may be shared with steps that still want it.
+	 */
+	void Reprioritize(FAsyncMixinLoadBatch& Batch, TAsyncLoadPriority Priority);
+
+	/** Drops the queued batches without issuing them */
+	void Reset();
+
+private:
+	struct FQueuedBatch
+	{
+		TSharedRef<FAsyncMixinLoadBatch> Batch;
+		TAsyncLoadPriority Priority;
+		uint64 Sequence;
+	};
+
+	void TryAdmit();
+	void ScheduleAdmit();
+	bool HasBudgetFor(int64 Bytes) const;
+	bool HandleAdmitTick(float DeltaTime);
+
+	// Heap ordered by priority, then by submission
+	TArray<FQueuedBatch> QueuedBatches;
+	uint64 NextSequence = 0;
+
+	int32 InFlightRequests = 0;
+	int64 InFlightBytes = 0;
+
+	// Issuing can call back into user code that submits more batches, those are admitted by the outer loop
+	bool bIsAdmitting = false;
+
+	FTSTicker::FDelegateHandle AdmitTickerHandle;
+};
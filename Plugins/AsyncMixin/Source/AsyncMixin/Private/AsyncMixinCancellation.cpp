@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinCancellation.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AsyncMixinHandleCache.h"
+#include "AsyncMixinRequestCoalescer.h"
+#include "AsyncMixinStats.h"
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinCancellation, Log, All);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Canceled Handles"), STAT_AsyncMixin_CanceledHandles, STATGROUP_AsyncMixin);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Skipped Paths"), STAT_AsyncMixin_SkippedPaths, STATGROUP_AsyncMixin);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pinned Packages"), STAT_AsyncMixin_PinnedPackages, STATGROUP_AsyncMixin);
+DECLARE_MEMORY_STAT(TEXT("Canceled Bytes (Disk)"), STAT_AsyncMixin_CanceledBytes, STATGROUP_AsyncMixin);
+
+namespace AsyncMixinCancellation
+{
+	static bool bCancelUnusedHandles = true;
+	static FAutoConsoleVariableRef CVarCancelUnusedHandles(
+		TEXT("AsyncMixin.CancelUnusedHandles"),
+		bCancelUnusedHandles,
+		TEXT("Cancel the streamable handles of loads that every mix-in has stopped waiting on."));
+
+	static uint64 NumCanceledHandles = 0;
+	static uint64 NumSkippedPaths = 0;
+	static uint64 NumPinnedPackages = 0;
+	static uint64 CanceledBytes = 0;
+
+	// Highest outstanding priority request per package, they keep the package loading whatever happens to its handles.
+	// Every request for a package completes when the package does, so the entry goes away with the first callback.
+	static TMap<FName, TAsyncLoadPriority> PriorityRequests;
+
+	static FAutoConsoleCommandWithOutputDevice CmdDumpCancellationStats(
+		TEXT("AsyncMixin.DumpCancellationStats"),
+		TEXT("Prints how many AsyncMixin loads were canceled or never issued, and the package bytes they would have read."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			Ar.Logf(TEXT("AsyncMixin cancellation: %llu handles canceled, %llu paths skipped, %.2f MB not read, %llu packages kept loading by priority requests"),
+				NumCanceledHandles, NumSkippedPaths, CanceledBytes / (1024.0 * 1024.0), NumPinnedPackages);
+		}));
+
+	int64 GetUnloadedDiskSize(const TArray<FSoftObjectPath>& SoftObjectPaths)
+	{
+		IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+		if (AssetRegistry == nullptr)
+		{
+			return 0;
+		}
+
+		TSet<FName, DefaultKeyFuncs<FName>, TInlineSetAllocator<16>> PackageNames;
+		int64 DiskSize = 0;
+
+		for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+		{
+			if (FAsyncMixinRequestCoalescer::IsFullyLoaded(SoftObjectPath))
+			{
+				continue;
+			}
+
+			bool bAlreadyCounted = false;
+			const FName PackageName = SoftObjectPath.GetLongPackageFName();
+			PackageNames.Add(PackageName, &bAlreadyCounted);
+
+			if (!bAlreadyCounted)
+			{
+				if (TOptional<FAssetPackageData> PackageData = AssetRegistry->GetAssetPackageDataCopy(PackageName))
+				{
+					DiskSize += FMath::Max<int64>(PackageData->DiskSize, 0);
+				}
+			}
+		}
+
+		return DiskSize;
+	}
+
+	/**
+	 * The streamable manager holds a reference to the handle for every requested path it's still loading, a reference
+	 * beyond those and ours belongs to someone else who still wants the load.  Paths that just finished may still be
+	 * counted as loading by the manager, in which case the handle looks shared and is only dropped.
+	 */
+	static bool IsSoleOwner(const TSharedPtr<FStreamableHandle>& Handle, const TArray<FSoftObjectPath>& RequestedAssets)
+	{
+		TSet<FSoftObjectPath, DefaultKeyFuncs<FSoftObjectPath>, TInlineSetAllocator<16>> LoadingPaths;
+		for (const FSoftObjectPath& RequestedAsset : RequestedAssets)
+		{
+			if (!FAsyncMixinRequestCoalescer::IsFullyLoaded(RequestedAsset))
+			{
+				LoadingPaths.Add(RequestedAsset);
+			}
+		}
+
+		return Handle.GetSharedReferenceCount() <= (1 + LoadingPaths.Num());
+	}
+
+	void ReleaseHandle(TSharedPtr<FStreamableHandle>& Handle)
+	{
+		check(IsInGameThread());
+
+		TSharedPtr<FStreamableHandle> ReleasedHandle = MoveTemp(Handle);
+
+		if (!bCancelUnusedHandles || !ReleasedHandle.IsValid() || !ReleasedHandle->IsLoadingInProgress())
+		{
+			return;
+		}
+
+		// The cache may be keeping a shared batch alive for the paths that did complete.
+		if (FAsyncMixinHandleCache::Get().IsRetained(ReleasedHandle.Get()))
+		{
+			return;
+		}
+
+		TArray<FSoftObjectPath> RequestedAssets;
+		ReleasedHandle->GetRequestedAssets(RequestedAssets);
+
+		if (!IsSoleOwner(ReleasedHandle, RequestedAssets))
+		{
+			UE_LOG(LogAsyncMixinCancellation, Verbose, TEXT("Dropping shared handle '%s' (%d references)"), *ReleasedHandle->GetDebugName(), ReleasedHandle.GetSharedReferenceCount());
+			return;
+		}
+
+		// Packages we raised the priority of are read anyway, they're not saved by canceling.
+		const int32 NumRequestedAssets = RequestedAssets.Num();
+		const int32 NumPinned = RequestedAssets.RemoveAllSwap([](const FSoftObjectPath& RequestedAsset)
+		{
+			return PriorityRequests.Contains(RequestedAsset.GetLongPackageFName());
+		});
+		const int64 DiskSize = GetUnloadedDiskSize(RequestedAssets);
+
+		UE_LOG(LogAsyncMixinCancellation, Verbose, TEXT("Canceling handle '%s' (%d assets, %d pinned by priority requests, %lld bytes not loaded)"),
+			*ReleasedHandle->GetDebugName(), NumRequestedAssets, NumPinned, DiskSize);
+
+		ReleasedHandle->CancelHandle();
+
+		++NumCanceledHandles;
+		NumPinnedPackages += NumPinned;
+		CanceledBytes += DiskSize;
+		INC_DWORD_STAT(STAT_AsyncMixin_CanceledHandles);
+		INC_DWORD_STAT_BY(STAT_AsyncMixin_PinnedPackages, NumPinned);
+		INC_MEMORY_STAT_BY(STAT_AsyncMixin_CanceledBytes, DiskSize);
+	}
+
+	void RequestPackagePriority(FName PackageName, TAsyncLoadPriority Priority)
+	{
+		check(IsInGameThread());
+
+		// A request at the same or a higher priority already bumped the package, another one would only add to the loader's queue.
+		if (const TAsyncLoadPriority* RequestedPriority = PriorityRequests.Find(PackageName); RequestedPriority && (*RequestedPriority >= Priority))
+		{
+			return;
+		}
+
+		PriorityRequests.Add(PackageName, Priority);
+
+		// Loaded callbacks are called on the game thread.
+		LoadPackageAsync(PackageName.ToString(), FLoadPackageAsyncDelegate::CreateLambda([](const FName& LoadedPackageName, UPackage*, EAsyncLoadingResult::Type)
+		{
+			PriorityRequests.Remove(LoadedPackageName);
+		}), Priority);
+	}
+
+	void RecordSkippedPaths(const TArray<FSoftObjectPath>& SoftObjectPaths)
+	{
+		const int64 DiskSize = GetUnloadedDiskSize(SoftObjectPaths);
+
+		NumSkippedPaths += SoftObjectPaths.Num();
+		CanceledBytes += DiskSize;
+		INC_DWORD_STAT_BY(STAT_AsyncMixin_SkippedPaths, SoftObjectPaths.Num());
+		INC_MEMORY_STAT_BY(STAT_AsyncMixin_CanceledBytes, DiskSize);
+	}
+}
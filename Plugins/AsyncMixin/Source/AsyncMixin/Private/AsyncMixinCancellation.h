@@ -0,0 +1,38 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Templates/SharedPointer.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/UObjectGlobals.h"
+
+struct FStreamableHandle;
+
+/**
+ * Cancellation of loads nobody is waiting on anymore, and the counters tracking how much reading that avoided.
+ *
+ * Game thread only.
+ */
+namespace AsyncMixinCancellation
+{
+	/**
+	 * Releases a handle owned by the AsyncMixin layer.  If it's still loading and we're its sole owner, the handle is
+	 * canceled so its packages stop competing with the loads that are still wanted.  Handles shared with anyone else,
+	 * e.g. the handle cache, are only dropped.
+	 */
+	void ReleaseHandle(TSharedPtr<FStreamableHandle>& Handle);
+
+	/**
+	 * Raises the priority of a package that's already being loaded by requesting it again from the package loader.
+	 * Does nothing if the package already has a request at the same or a higher priority.  The loader has no way to
+	 * cancel a single request, so these are tracked until the package loads: canceled handles leave the packages they
+	 * pin out of the bytes saved, and count them as loads cancellation couldn't stop.
+	 */
+	void RequestPackagePriority(FName PackageName, TAsyncLoadPriority Priority);
+
+	/** Records paths dropped from a batch before its request was issued */
+	void RecordSkippedPaths(const TArray<FSoftObjectPath>& SoftObjectPaths);
+
+	/** Size on disk of the packages of the paths that haven't finished loading yet, counting each package once */
+	int64 GetUnloadedDiskSize(const TArray<FSoftObjectPath>& SoftObjectPaths);
+}
@@ -0,0 +1,143 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinCoroutine.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace AsyncMixinCoroutine
+{
+	static int32 MaxPooledFrames = 32;
+	static FAutoConsoleVariableRef CVarMaxPooledFrames(
+		TEXT("AsyncMixin.Coroutine.MaxPooledFrames"),
+		MaxPooledFrames,
+		TEXT("Maximum number of free coroutine frames kept per size class for the next FAsyncMixinTask."));
+
+	/**
+	 * Free lists of coroutine frames bucketed by power of two size classes.  Frames are allocated when a coroutine is
+	 * called and freed when it finishes or is destroyed, both on the game thread.
+	 */
+	class FFramePool
+	{
+	public:
+		~FFramePool()
+		{
+			for (TArray<void*>& Frames : FreeFrames)
+			{
+				for (void* Frame : Frames)
+				{
+					FMemory::Free(Frame);
+				}
+			}
+		}
+
+		void* Allocate(SIZE_T Size)
+		{
+			check(IsInGameThread());
+
+			const int32 SizeClass = GetSizeClass(Size);
+			if (SizeClass == INDEX_NONE)
+			{
+				return FMemory::Malloc(Size);
+			}
+
+			if (FreeFrames[SizeClass].Num() > 0)
+			{
+				return FreeFrames[SizeClass].Pop(/*bAllowShrinking*/false);
+			}
+
+			return FMemory::Malloc(GetSizeClassBytes(SizeClass));
+		}
+
+		void Free(void* Frame, SIZE_T Size)
+		{
+			check(IsInGameThread());
+
+			const int32 SizeClass = GetSizeClass(Size);
+			if ((SizeClass != INDEX_NONE) && (FreeFrames[SizeClass].Num() < MaxPooledFrames))
+			{
+				FreeFrames[SizeClass].Add(Frame);
+			}
+			else
+			{
+				FMemory::Free(Frame);
+			}
+		}
+
+	private:
+		static constexpr int32 MinSizeClassBytes = 128;
+		static constexpr int32 NumSizeClasses = 5;
+
+		static int32 GetSizeClass(SIZE_T Size)
+		{
+			for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+			{
+				if (Size <= GetSizeClassBytes(SizeClass))
+				{
+					return SizeClass;
+				}
+			}
+
+			return INDEX_NONE;
+		}
+
+		static SIZE_T GetSizeClassBytes(int32 SizeClass) { return SIZE_T(MinSizeClassBytes) << SizeClass; }
+
+		TArray<void*> FreeFrames[NumSizeClasses];
+	};
+
+	static FFramePool& GetFramePool()
+	{
+		static FFramePool FramePool;
+		return FramePool;
+	}
+}
+
+void* FAsyncMixinTask::promise_type::operator new(SIZE_T Size)
+{
+	return AsyncMixinCoroutine::GetFramePool().Allocate(Size);
+}
+
+void FAsyncMixinTask::promise_type::operator delete(void* Memory, SIZE_T Size)
+{
+	AsyncMixinCoroutine::GetFramePool().Free(Memory, Size);
+}
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+FAsyncMixinLoadAwaiter FAsyncMixin::AsyncLoadAwait(const TArray<FSoftObjectPath>& SoftObjectPaths, TAsyncLoadPriority Priority)
+{
+	return FAsyncMixinLoadAwaiter(*this, TArray<FSoftObjectPath>(SoftObjectPaths), Priority);
+}
+
+FAsyncMixinLoadAwaiter::FAsyncMixinLoadAwaiter(FAsyncMixin& InMixin, TArray<FSoftObjectPath>&& InSoftObjectPaths, TAsyncLoadPriority InPriority)
+	: Mixin(InMixin)
+	, SoftObjectPaths(MoveTemp(InSoftObjectPaths))
+	, Priority(InPriority)
+{
+}
+
+bool FAsyncMixinLoadAwaiter::await_ready() const
+{
+	// Anything still loading has to call back first, skipping ahead would break the order of the sequence.
+	if (Mixin.IsLoadingInProgressOrPending())
+	{
+		return false;
+	}
+
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		if (!SoftObjectPath.IsNull() && (SoftObjectPath.ResolveObject() == nullptr))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FAsyncMixinLoadAwaiter::await_suspend(std::coroutine_handle<> Handle)
+{
+	// Resumed by the loading state like any other step, never from in here, the coroutine isn't done suspending yet.
+	Mixin.GetLoadingState().AsyncLoadAndResume(MoveTemp(SoftObjectPaths), Handle.address(), Priority);
+}
@@ -0,0 +1,262 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinDependencyManifest.h"
+
+#include "AsyncMixinRequestCoalescer.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinDependencyManifest, Log, All);
+
+namespace AsyncMixinCVars
+{
+	static bool bUseDependencyManifest = true;
+	static FAutoConsoleVariableRef CVarUseDependencyManifest(
+		TEXT("AsyncMixin.DependencyManifest.Enable"),
+		bUseDependencyManifest,
+		TEXT("Request the precomputed dependency closure of AsyncMixin loads together with them, instead of discovering it while loading."));
+}
+
+FAsyncMixinDependencyManifest& FAsyncMixinDependencyManifest::Get()
+{
+	static FAsyncMixinDependencyManifest Instance;
+	return Instance;
+}
+
+FString FAsyncMixinDependencyManifest::GetDefaultPath()
+{
+	return FPaths::ProjectContentDir() / TEXT("AsyncMixin") / TEXT("DependencyManifest.bin");
+}
+
+int32 FAsyncMixinDependencyManifest::FindOrAddPackage(const FSoftObjectPath& SoftObjectPath)
+{
+	const FName PackageName = SoftObjectPath.GetLongPackageFName();
+	if (const int32* PackageIndex = PackageIndices.Find(PackageName))
+	{
+		return *PackageIndex;
+	}
+
+	const int32 PackageIndex = Packages.Add(SoftObjectPath);
+	PackageIndices.Add(PackageName, PackageIndex);
+	return PackageIndex;
+}
+
+void FAsyncMixinDependencyManifest::AddClosure(const FSoftObjectPath& Root, const TArray<FSoftObjectPath>& Dependencies)
+{
+	const int32 RootIndex = FindOrAddPackage(Root);
+
+	TArray<int32>& Closure = Closures.FindOrAdd(RootIndex);
+	for (const FSoftObjectPath& Dependency : Dependencies)
+	{
+		const int32 DependencyIndex = FindOrAddPackage(Dependency);
+		if (DependencyIndex != RootIndex)
+		{
+			Closure.AddUnique(DependencyIndex);
+		}
+	}
+}
+
+void FAsyncMixinDependencyManifest::AppendClosure(TArray<FSoftObjectPath>& SoftObjectPaths) const
+{
+	if (!AsyncMixinCVars::bUseDependencyManifest || (Closures.Num() == 0))
+	{
+		return;
+	}
+
+	// Everything already in the request, or added to it, so each dependency is only checked once.
+	TSet<FSoftObjectPath, DefaultKeyFuncs<FSoftObjectPath>, TInlineSetAllocator<64>> Requested;
+	Requested.Append(SoftObjectPaths);
+
+	const int32 NumRequested = SoftObjectPaths.Num();
+	for (int32 PathIndex = 0; PathIndex < NumRequested; ++PathIndex)
+	{
+		const int32* RootIndex = PackageIndices.Find(SoftObjectPaths[PathIndex].GetLongPackageFName());
+		const TArray<int32>* Closure = RootIndex ? Closures.Find(*RootIndex) : nullptr;
+		if (Closure == nullptr)
+		{
+			continue;
+		}
+
+		for (const int32 DependencyIndex : *Closure)
+		{
+			const FSoftObjectPath& Dependency = Packages[DependencyIndex];
+
+			bool bAlreadyRequested = false;
+			Requested.Add(Dependency, &bAlreadyRequested);
+
+			if (!bAlreadyRequested && !FAsyncMixinRequestCoalescer::IsFullyLoaded(Dependency))
+			{
+				SoftObjectPaths.Add(Dependency);
+			}
+		}
+	}
+}
+
+void FAsyncMixinDependencyManifest::Serialize(FArchive& Ar)
+{
+	// Counts and indices are packed, most of them are small.
+	uint32 NumPackages = Packages.Num();
+	Ar.SerializeIntPacked(NumPackages);
+
+	// Counts come straight from the file, don't size anything by one the rest of the file couldn't hold.  Every package
+	// path takes at least its length, every closure its root and count, and every dependency a byte.
+	const auto FitsInArchive = [&Ar](uint32 Count, int64 MinBytesEach)
+	{
+		return Count <= (Ar.TotalSize() - Ar.Tell()) / MinBytesEach;
+	};
+
+	if (Ar.IsLoading())
+	{
+		if (!FitsInArchive(NumPackages, sizeof(int32)))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Packages.SetNum(NumPackages);
+	}
+
+	for (FSoftObjectPath& Package : Packages)
+	{
+		FString PackagePath = Package.ToString();
+		Ar << PackagePath;
+
+		if (Ar.IsError())
+		{
+			return;
+		}
+
+		if (Ar.IsLoading())
+		{
+			Package = FSoftObjectPath(PackagePath);
+		}
+	}
+
+	uint32 NumClosures = Closures.Num();
+	Ar.SerializeIntPacked(NumClosures);
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || !FitsInArchive(NumClosures, 2))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Closures.Empty(NumClosures);
+
+		for (uint32 ClosureIndex = 0; (ClosureIndex < NumClosures) && !Ar.IsError(); ++ClosureIndex)
+		{
+			uint32 RootIndex = 0;
+			uint32 NumDependencies = 0;
+			Ar.SerializeIntPacked(RootIndex);
+			Ar.SerializeIntPacked(NumDependencies);
+
+			if (Ar.IsError() || !FitsInArchive(NumDependencies, 1))
+			{
+				Ar.SetError();
+				return;
+			}
+
+			TArray<int32>& Closure = Closures.Add(RootIndex);
+			Closure.Reserve(NumDependencies);
+
+			for (uint32 Index = 0; (Index < NumDependencies) && !Ar.IsError(); ++Index)
+			{
+				uint32 DependencyIndex = 0;
+				Ar.SerializeIntPacked(DependencyIndex);
+				Closure.Add(DependencyIndex);
+			}
+		}
+	}
+	else
+	{
+		for (TPair<int32, TArray<int32>>& Pair : Closures)
+		{
+			uint32 RootIndex = Pair.Key;
+			uint32 NumDependencies = Pair.Value.Num();
+			Ar.SerializeIntPacked(RootIndex);
+			Ar.SerializeIntPacked(NumDependencies);
+
+			for (int32 DependencyIndex : Pair.Value)
+			{
+				uint32 PackedIndex = DependencyIndex;
+				Ar.SerializeIntPacked(PackedIndex);
+			}
+		}
+	}
+}
+
+bool FAsyncMixinDependencyManifest::LoadFromFile(const FString& Filename)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Ar(Bytes);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Ar << Magic << Version;
+
+	if ((Magic != FileMagic) || (Version != FileVersion))
+	{
+		UE_LOG(LogAsyncMixinDependencyManifest, Warning, TEXT("Ignoring '%s', it isn't a version %u dependency manifest"), *Filename, FileVersion);
+		return false;
+	}
+
+	Reset();
+	Serialize(Ar);
+
+	// Don't trust anything out of a truncated or corrupted file.
+	bool bValid = !Ar.IsError();
+	for (const TPair<int32, TArray<int32>>& Pair : Closures)
+	{
+		bValid &= Packages.IsValidIndex(Pair.Key);
+		for (int32 DependencyIndex : Pair.Value)
+		{
+			bValid &= Packages.IsValidIndex(DependencyIndex);
+		}
+	}
+
+	if (!bValid)
+	{
+		UE_LOG(LogAsyncMixinDependencyManifest, Warning, TEXT("Failed to read the dependency manifest '%s'"), *Filename);
+		Reset();
+		return false;
+	}
+
+	for (int32 PackageIndex = 0; PackageIndex < Packages.Num(); ++PackageIndex)
+	{
+		PackageIndices.Add(Packages[PackageIndex].GetLongPackageFName(), PackageIndex);
+	}
+
+	UE_LOG(LogAsyncMixinDependencyManifest, Log, TEXT("Loaded %d dependency closures over %d packages"), Closures.Num(), Packages.Num());
+	return true;
+}
+
+bool FAsyncMixinDependencyManifest::SaveToFile(const FString& Filename)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Ar(Bytes);
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	Ar << Magic << Version;
+
+	Serialize(Ar);
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Filename);
+}
+
+void FAsyncMixinDependencyManifest::Reset()
+{
+	Packages.Reset();
+	PackageIndices.Reset();
+	Closures.Reset();
+}
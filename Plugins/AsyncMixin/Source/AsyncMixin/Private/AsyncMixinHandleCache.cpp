@@ -0,0 +1,178 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinHandleCache.h"
+
+#include "Engine/StreamableManager.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinHandleCache, Log, All);
+
+namespace AsyncMixinCVars
+{
+	static float HandleCacheBudgetMB = 64.0f;
+	static FAutoConsoleVariableRef CVarHandleCacheBudgetMB(
+		TEXT("AsyncMixin.HandleCache.BudgetMB"),
+		HandleCacheBudgetMB,
+		TEXT("Estimated size of the assets kept resident for mix-ins using EAsyncMixinRetentionPolicy::KeepResidentUntilEvicted, 0 disables the cache."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+		{
+			FAsyncMixinHandleCache::Get().EvictToBudget();
+		}));
+
+	static FAutoConsoleCommand CmdHandleCacheFlush(
+		TEXT("AsyncMixin.HandleCache.Flush"),
+		TEXT("Releases every handle kept resident by the AsyncMixin handle cache."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			FAsyncMixinHandleCache& Cache = FAsyncMixinHandleCache::Get();
+			UE_LOG(LogAsyncMixinHandleCache, Log, TEXT("Flushing %d handles (%.2f MB)"), Cache.Num(), Cache.GetTotalBytes() / (1024.0 * 1024.0));
+			Cache.Empty();
+		}));
+}
+
+FAsyncMixinHandleCache& FAsyncMixinHandleCache::Get()
+{
+	static FAsyncMixinHandleCache Instance;
+	return Instance;
+}
+
+FAsyncMixinHandleCache::FAsyncMixinHandleCache()
+	: Entries(MaxEntries)
+{
+}
+
+void FAsyncMixinHandleCache::Retain(const TSharedPtr<FStreamableHandle>& Handle)
+{
+	if (Handle.IsValid())
+	{
+		TArray<FSoftObjectPath> RequestedAssets;
+		Handle->GetRequestedAssets(RequestedAssets);
+		Retain(Handle, RequestedAssets);
+	}
+}
+
+void FAsyncMixinHandleCache::Retain(const TSharedPtr<FStreamableHandle>& Handle, const TArray<FSoftObjectPath>& Assets)
+{
+	check(IsInGameThread());
+
+	// Shared handles may still be loading other paths, only the requested assets need to be there.
+	if (!Handle.IsValid() || Handle->WasCanceled() || (AsyncMixinCVars::HandleCacheBudgetMB <= 0.0f))
+	{
+		return;
+	}
+
+	bool bRetainsAny = false;
+	for (const FSoftObjectPath& RequestedAsset : Assets)
+	{
+		if (RequestedAsset.ResolveObject() != nullptr)
+		{
+			// An asset requested again through a newer handle refreshes that one, the older one ages out on its own.
+			AssetHandles.Add(RequestedAsset, Handle.Get());
+			bRetainsAny = true;
+		}
+	}
+
+	if (!bRetainsAny)
+	{
+		return;
+	}
+
+	if (Entries.FindAndTouch(Handle.Get()) == nullptr)
+	{
+		if (Entries.Num() >= Entries.Max())
+		{
+			// Evict ourselves so the byte count stays in sync, the cache would silently drop the entry otherwise.
+			RemoveLeastRecent();
+		}
+
+		// Charged once, the handle keeps every one of its assets alive however many of them are asked for.
+		FEntry Entry;
+		Entry.Handle = Handle;
+		Entry.SizeBytes = EstimateSize(*Handle);
+
+		TotalBytes += Entry.SizeBytes;
+		Entries.Add(Handle.Get(), MoveTemp(Entry));
+	}
+
+	EvictToBudget();
+}
+
+void FAsyncMixinHandleCache::Touch(const FSoftObjectPath& SoftObjectPath)
+{
+	if (Entries.Num() > 0)
+	{
+		if (const FStreamableHandle* const* Handle = AssetHandles.Find(SoftObjectPath))
+		{
+			Entries.FindAndTouch(*Handle);
+		}
+	}
+}
+
+void FAsyncMixinHandleCache::Touch(const TArray<FSoftObjectPath>& SoftObjectPaths)
+{
+	if (Entries.Num() > 0)
+	{
+		for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+		{
+			Touch(SoftObjectPath);
+		}
+	}
+}
+
+void FAsyncMixinHandleCache::EvictToBudget()
+{
+	const SIZE_T BudgetBytes = static_cast<SIZE_T>(FMath::Max(AsyncMixinCVars::HandleCacheBudgetMB, 0.0f) * 1024.0 * 1024.0);
+
+	while ((Entries.Num() > 0) && (TotalBytes > BudgetBytes))
+	{
+		RemoveLeastRecent();
+	}
+}
+
+void FAsyncMixinHandleCache::Empty()
+{
+	Entries.Empty(MaxEntries);
+	AssetHandles.Empty();
+	TotalBytes = 0;
+}
+
+SIZE_T FAsyncMixinHandleCache::EstimateSize(const FStreamableHandle& Handle)
+{
+	TArray<UObject*> LoadedAssets;
+	Handle.GetLoadedAssets(LoadedAssets);
+
+	SIZE_T SizeBytes = 0;
+	for (const UObject* LoadedAsset : LoadedAssets)
+	{
+		if (LoadedAsset != nullptr)
+		{
+			SizeBytes += LoadedAsset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	}
+
+	return SizeBytes;
+}
+
+void FAsyncMixinHandleCache::RemoveLeastRecent()
+{
+	// Dropping the handle only releases the assets if nothing else is holding them.
+	const FEntry Evicted = Entries.RemoveLeastRecent();
+	ReleaseEntry(Evicted);
+}
+
+void FAsyncMixinHandleCache::ReleaseEntry(const FEntry& Entry)
+{
+	TotalBytes -= Entry.SizeBytes;
+
+	// Forget the assets that would refresh the evicted handle, unless they've moved on to a newer one.
+	TArray<FSoftObjectPath> RequestedAssets;
+	Entry.Handle->GetRequestedAssets(RequestedAssets);
+
+	for (const FSoftObjectPath& RequestedAsset : RequestedAssets)
+	{
+		if (const FStreamableHandle* const* Handle = AssetHandles.Find(RequestedAsset); Handle && (*Handle == Entry.Handle.Get()))
+		{
+			AssetHandles.Remove(RequestedAsset);
+		}
+	}
+}
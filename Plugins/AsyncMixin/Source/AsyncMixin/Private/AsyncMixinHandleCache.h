@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/LruCache.h"
+#include "Templates/SharedPointer.h"
+#include "UObject/SoftObjectPath.h"
+
+struct FStreamableHandle;
+
+/**
+ * Keeps the streamable handles of recently completed loads alive so their assets stay resident after the loading
+ * state that requested them is gone.  Entries are kept per handle, since evicting one asset of a handle that's still
+ * cached for its siblings frees nothing.  Each handle is charged the estimated size of all of its loaded assets once,
+ * and the least recently used handles are evicted first once the total goes over AsyncMixin.HandleCache.BudgetMB.
+ * Assets shared by two cached handles are charged to both, which errs on the side of evicting too much.
+ *
+ * Game thread only.
+ */
+class FAsyncMixinHandleCache
+{
+public:
+	static FAsyncMixinHandleCache& Get();
+
+	/** Caches a completed handle, refreshing it if it's already cached */
+	void Retain(const TSharedPtr<FStreamableHandle>& Handle);
+
+	/** Caches a completed handle shared with other requests, only the given assets refresh it when requested again */
+	void Retain(const TSharedPtr<FStreamableHandle>& Handle, const TArray<FSoftObjectPath>& Assets);
+
+	/** Marks the handles caching the assets as recently used, called when they are requested again */
+	void Touch(const FSoftObjectPath& SoftObjectPath);
+	void Touch(const TArray<FSoftObjectPath>& SoftObjectPaths);
+
+	/** Evicts the least recently used handles until the cache fits in the budget */
+	void EvictToBudget();
+
+	/** Releases every cached handle */
+	void Empty();
+
+	/** @return true if the cache is keeping the handle alive */
+	bool IsRetained(const FStreamableHandle* Handle) const { return Entries.Contains(Handle); }
+
+	int32 Num() const { return Entries.Num(); }
+	SIZE_T GetTotalBytes() const { return TotalBytes; }
+
+private:
+	FAsyncMixinHandleCache();
+
+	static constexpr int32 MaxEntries = 4096;
+
+	struct FEntry
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		SIZE_T SizeBytes = 0;
+	};
+
+	static SIZE_T EstimateSize(const FStreamableHandle& Handle);
+
+	void RemoveLeastRecent();
+	void ReleaseEntry(const FEntry& Entry);
+
+	TLruCache<const FStreamableHandle*, FEntry> Entries;
+
+	// The cached handle each asset refreshes when it's requested again
+	TMap<FSoftObjectPath, const FStreamableHandle*> AssetHandles;
+	SIZE_T TotalBytes = 0;
+};
@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixin.h"
+#include "AsyncMixinAccessRecorder.h"
+#include "AsyncMixinAdmission.h"
+#include "AsyncMixinDependencyManifest.h"
+#include "AsyncMixinHandleCache.h"
+#include "AsyncMixinRequestCoalescer.h"
+#include "AsyncMixinScheduler.h"
+#include "Modules/ModuleManager.h"
+
+class FAsyncMixinModule : public IModuleInterface
+{
+public:
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
+
+void FAsyncMixinModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	// Warm sessions start out with the access patterns recorded by the previous ones.
+	FAsyncMixinAccessRecorder::Get().Load();
+
+	// Written by the AsyncMixinDependencyManifest commandlet, without it dependencies are discovered while loading.
+	FAsyncMixinDependencyManifest::Get().LoadFromFile(FAsyncMixinDependencyManifest::GetDefaultPath());
+}
+
+void FAsyncMixinModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+
+	FAsyncMixinAccessRecorder::Get().Save();
+
+	// Release the cached handles and pending batches while the streamable manager is still around.
+	FAsyncMixinAccessRecorder::Get().Reset();
+	FAsyncMixinScheduler::Get().Reset();
+	FAsyncMixinRequestCoalescer::Get().Reset();
+	FAsyncMixinAdmissionController::Get().Reset();
+	FAsyncMixinHandleCache::Get().Empty();
+	FAsyncMixinDependencyManifest::Get().Reset();
+
+	// Pooled states hold on to their step chunks, don't let them outlive the module.
+	FAsyncMixin::LoadingStatePool.Empty();
+}
+	
+IMPLEMENT_MODULE(FAsyncMixinModule, AsyncMixin)
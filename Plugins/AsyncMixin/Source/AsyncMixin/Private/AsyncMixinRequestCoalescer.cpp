@@ -0,0 +1,351 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinRequestCoalescer.h"
+
+#include "AsyncMixinAdmission.h"
+#include "AsyncMixinCancellation.h"
+#include "AsyncMixinDependencyManifest.h"
+#include "AsyncMixinStats.h"
+#include "Engine/AssetManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Stats/Stats.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinCoalescer, Log, All);
+
+namespace AsyncMixinCVars
+{
+	static bool bCoalesceRequests = true;
+	static FAutoConsoleVariableRef CVarCoalesceRequests(
+		TEXT("AsyncMixin.CoalesceRequests"),
+		bCoalesceRequests,
+		TEXT("Batch the AsyncLoad requests of every mix-in made during a frame into one streamable request per priority."));
+}
+
+//////////////////////////////////////////////////////////////////////
+// FAsyncMixinLoadBatch
+
+FAsyncMixinLoadBatch::FAsyncMixinLoadBatch(TAsyncLoadPriority InPriority)
+	: Priority(InPriority)
+{
+}
+
+FAsyncMixinLoadBatch::~FAsyncMixinLoadBatch()
+{
+	if (Handle.IsValid())
+	{
+		Handle->BindCompleteDelegate(FStreamableDelegate());
+		Handle->BindCancelDelegate(FStreamableDelegate());
+		Handle->BindUpdateDelegate(FStreamableUpdateDelegate());
+
+		// Every step waiting on the batch is gone.
+		AsyncMixinCancellation::ReleaseHandle(Handle);
+	}
+
+	ReleaseAdmission();
+}
+
+bool FAsyncMixinLoadBatch::IsComplete(const TArray<FSoftObjectPath>& SoftObjectPaths) const
+{
+	if (!bIssued)
+	{
+		return false;
+	}
+
+	if (!Handle.IsValid() || Handle->HasLoadCompleted() || Handle->WasCanceled())
+	{
+		return true;
+	}
+
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		if (!FAsyncMixinRequestCoalescer::IsFullyLoaded(SoftObjectPath))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FAsyncMixinLoadBatch::AddWaiter(const void* Key, const TArray<FSoftObjectPath>& SoftObjectPaths, const FSimpleDelegate& Delegate)
+{
+	RemoveWaiter(Key);
+
+	FWaiter& Waiter = Waiters.AddDefaulted_GetRef();
+	Waiter.Key = Key;
+	Waiter.SoftObjectPaths = &SoftObjectPaths;
+	Waiter.Delegate = Delegate;
+}
+
+void FAsyncMixinLoadBatch::RemoveWaiter(const void* Key)
+{
+	Waiters.RemoveAllSwap([Key](const FWaiter& Waiter) { return Waiter.Key == Key; }, /*bAllowShrinking*/false);
+}
+
+void FAsyncMixinLoadBatch::ReleasePaths(const TArray<FSoftObjectPath>& SoftObjectPaths)
+{
+	if (bIssued)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath, TInlineAllocator<8>> DroppedPaths;
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		if (int32* RefCount = PendingPaths.Find(SoftObjectPath))
+		{
+			if (--(*RefCount) == 0)
+			{
+				PendingPaths.Remove(SoftObjectPath);
+				DroppedPaths.Add(SoftObjectPath);
+			}
+		}
+	}
+
+	if (DroppedPaths.Num() > 0)
+	{
+		bPathsExpanded = false;
+		AsyncMixinCancellation::RecordSkippedPaths(TArray<FSoftObjectPath>(DroppedPaths));
+	}
+}
+
+void FAsyncMixinLoadBatch::Issue()
+{
+	check(!bIssued);
+
+	// Usually expanded already by the admission controller to size the request.
+	TArray<FSoftObjectPath> SoftObjectPaths = MoveTemp(GetExpandedPaths());
+	PendingPaths.Empty();
+	bPathsExpanded = false;
+
+	UE_LOG(LogAsyncMixinCoalescer, Verbose, TEXT("[0x%X] Issuing %d paths at priority %d for %d waiters"), this, SoftObjectPaths.Num(), Priority, Waiters.Num());
+
+	IssueTime = FPlatformTime::Seconds();
+	Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(SoftObjectPaths), FStreamableDelegate(), Priority, false, false, TEXT("AsyncMixin"));
+	bIssued = true;
+
+	if (Handle.IsValid() && Handle->IsLoadingInProgress())
+	{
+		Handle->BindCompleteDelegate(FStreamableDelegate::CreateSP(this, &FAsyncMixinLoadBatch::HandleComplete));
+		Handle->BindCancelDelegate(FStreamableDelegate::CreateSP(this, &FAsyncMixinLoadBatch::HandleComplete));
+		Handle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateSP(this, &FAsyncMixinLoadBatch::HandleUpdate));
+	}
+	else
+	{
+		ReleaseAdmission();
+		NotifyWaiters();
+	}
+}
+
+TArray<FSoftObjectPath>& FAsyncMixinLoadBatch::GetExpandedPaths()
+{
+	if (!bPathsExpanded)
+	{
+		PendingPaths.GenerateKeyArray(ExpandedPaths);
+
+		// Ask for the whole dependency tree now instead of having the loader find it one package at a time.
+		FAsyncMixinDependencyManifest::Get().AppendClosure(ExpandedPaths);
+		bPathsExpanded = true;
+	}
+
+	return ExpandedPaths;
+}
+
+void FAsyncMixinLoadBatch::HandleComplete()
+{
+	ReleaseAdmission();
+	NotifyWaiters();
+}
+
+void FAsyncMixinLoadBatch::ReleaseAdmission()
+{
+	if (bHoldsAdmission)
+	{
+		bHoldsAdmission = false;
+		FAsyncMixinAdmissionController::Get().Release(AdmittedBytes);
+	}
+}
+
+void FAsyncMixinLoadBatch::NotifyWaiters()
+{
+	// Waiters call back into loading states that may add or remove waiters, collect the ready ones first.
+	TArray<FSimpleDelegate, TInlineAllocator<8>> ReadyDelegates;
+	for (int32 WaiterIndex = Waiters.Num() - 1; WaiterIndex >= 0; --WaiterIndex)
+	{
+		if (IsComplete(*Waiters[WaiterIndex].SoftObjectPaths))
+		{
+			ReadyDelegates.Add(MoveTemp(Waiters[WaiterIndex].Delegate));
+			Waiters.RemoveAtSwap(WaiterIndex, 1, /*bAllowShrinking*/false);
+		}
+	}
+
+	// Keep ourselves alive, the last step holding the batch may be destroyed by its callback.
+	TSharedRef<FAsyncMixinLoadBatch> KeepAlive = AsShared();
+	for (const FSimpleDelegate& Delegate : ReadyDelegates)
+	{
+		Delegate.ExecuteIfBound();
+	}
+}
+
+void FAsyncMixinLoadBatch::HandleUpdate(TSharedRef<FStreamableHandle> UpdatedHandle)
+{
+	NotifyWaiters();
+}
+
+//////////////////////////////////////////////////////////////////////
+// FAsyncMixinRequestCoalescer
+
+FAsyncMixinRequestCoalescer& FAsyncMixinRequestCoalescer::Get()
+{
+	static FAsyncMixinRequestCoalescer Instance;
+	return Instance;
+}
+
+bool FAsyncMixinRequestCoalescer::IsFullyLoaded(const FSoftObjectPath& SoftObjectPath)
+{
+	const UObject* Object = SoftObjectPath.ResolveObject();
+	return Object
+		&& !Object->HasAnyFlags(RF_NeedLoad | RF_NeedPostLoad)
+		&& !Object->HasAnyInternalFlags(EInternalObjectFlags::AsyncLoading);
+}
+
+bool FAsyncMixinRequestCoalescer::ShouldCoalesce(const TArray<FSoftObjectPath>& SoftObjectPaths) const
+{
+	if (!AsyncMixinCVars::bCoalesceRequests)
+	{
+		return false;
+	}
+
+	// If everything is already loaded, request it right away so the step can complete without waiting a frame.
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		if (!IsFullyLoaded(SoftObjectPath))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TSharedRef<FAsyncMixinLoadBatch> FAsyncMixinRequestCoalescer::Request(const TArray<FSoftObjectPath>& SoftObjectPaths, TAsyncLoadPriority Priority)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FAsyncMixinLoadBatch>* Batch = PendingBatches.Find(Priority);
+	if (Batch == nullptr)
+	{
+		Batch = &PendingBatches.Add(Priority, MakeShared<FAsyncMixinLoadBatch>(Priority));
+	}
+
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		(*Batch)->PendingPaths.FindOrAdd(SoftObjectPath)++;
+	}
+	(*Batch)->bPathsExpanded = false;
+
+	if (!FlushTickerHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(1);
+		FlushTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAsyncMixinRequestCoalescer::HandleFlushTick));
+	}
+
+	return *Batch;
+}
+
+TSharedRef<FAsyncMixinLoadBatch> FAsyncMixinRequestCoalescer::RequestNow(const TArray<FSoftObjectPath>& SoftObjectPaths, TAsyncLoadPriority Priority)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FAsyncMixinLoadBatch> Batch = MakeShared<FAsyncMixinLoadBatch>(Priority);
+	for (const FSoftObjectPath& SoftObjectPath : SoftObjectPaths)
+	{
+		Batch->PendingPaths.FindOrAdd(SoftObjectPath)++;
+	}
+
+	FAsyncMixinAdmissionController::Get().Submit(Batch);
+	return Batch;
+}
+
+void FAsyncMixinRequestCoalescer::Flush()
+{
+	check(IsInGameThread());
+
+	RemoveFlushTicker();
+
+	// Issuing can complete synchronously and call back into user code that requests more loads, those go in the next batch.
+	TArray<TSharedRef<FAsyncMixinLoadBatch>> BatchesToIssue = MoveTemp(DetachedBatches);
+	DetachedBatches.Reset();
+
+	for (const TPair<TAsyncLoadPriority, TSharedRef<FAsyncMixinLoadBatch>>& Pair : PendingBatches)
+	{
+		BatchesToIssue.Add(Pair.Value);
+	}
+	PendingBatches.Reset();
+
+	// Highest priority first, so it's the first in line if there's only budget for some of them.
+	BatchesToIssue.StableSort([](const TSharedRef<FAsyncMixinLoadBatch>& A, const TSharedRef<FAsyncMixinLoadBatch>& B)
+	{
+		return A->Priority > B->Priority;
+	});
+
+	FAsyncMixinAdmissionController& AdmissionController = FAsyncMixinAdmissionController::Get();
+	for (const TSharedRef<FAsyncMixinLoadBatch>& Batch : BatchesToIssue)
+	{
+		// Every step that wanted the batch may have been canceled already.
+		if (!Batch.IsUnique() && (Batch->PendingPaths.Num() > 0))
+		{
+			AdmissionController.Submit(Batch);
+		}
+	}
+}
+
+void FAsyncMixinRequestCoalescer::Reprioritize(FAsyncMixinLoadBatch& Batch, TAsyncLoadPriority OldPriority)
+{
+	check(IsInGameThread());
+
+	const TSharedRef<FAsyncMixinLoadBatch>* PendingBatch = PendingBatches.Find(OldPriority);
+	if ((PendingBatch == nullptr) || (&PendingBatch->Get() != &Batch))
+	{
+		return;
+	}
+
+	const TSharedRef<FAsyncMixinLoadBatch> RaisedBatch = *PendingBatch;
+	PendingBatches.Remove(OldPriority);
+
+	// Steps are already waiting on both batches, so they can't be merged, keep this one aside until the flush.
+	if (PendingBatches.Contains(Batch.Priority))
+	{
+		DetachedBatches.Add(RaisedBatch);
+	}
+	else
+	{
+		PendingBatches.Add(Batch.Priority, RaisedBatch);
+	}
+}
+
+void FAsyncMixinRequestCoalescer::Reset()
+{
+	RemoveFlushTicker();
+	PendingBatches.Reset();
+	DetachedBatches.Reset();
+}
+
+void FAsyncMixinRequestCoalescer::RemoveFlushTicker()
+{
+	if (FlushTickerHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(-1);
+		FTSTicker::GetCoreTicker().RemoveTicker(FlushTickerHandle);
+		FlushTickerHandle.Reset();
+	}
+}
+
+bool FAsyncMixinRequestCoalescer::HandleFlushTick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinRequestCoalescer_Flush);
+
+	// Flush clears the ticker handle, returning false lets the ticker drop the delegate.
+	Flush();
+	return false;
+}
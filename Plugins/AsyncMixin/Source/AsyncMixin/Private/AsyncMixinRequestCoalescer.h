@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "Templates/SharedPointer.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * Every path requested at one priority during a frame, issued as a single streamable request at the end of it.
+ *
+ * Steps wait on the batch instead of a handle of their own.  A step completes as soon as its own paths are loaded,
+ * it doesn't wait for the rest of the batch.
+ */
+class FAsyncMixinLoadBatch : public TSharedFromThis<FAsyncMixinLoadBatch>
+{
+public:
+	explicit FAsyncMixinLoadBatch(TAsyncLoadPriority InPriority);
+	~FAsyncMixinLoadBatch();
+
+	/** Has the streamable request been issued yet, batches wait in the admission controller until there's budget */
+	bool IsIssued() const { return bIssued; }
+
+	/** The priority the batch is requested at, only ever raised once it's shared by steps */
+	TAsyncLoadPriority GetPriority() const { return Priority; }
+
+	/** @return true once every one of the given paths is loaded, or the batch has finished */
+	bool IsComplete(const TArray<FSoftObjectPath>& SoftObjectPaths) const;
+
+	/** When the streamable request was issued, in FPlatformTime::Seconds */
+	double GetIssueTime() const { return IssueTime; }
+
+	/** The handle of the batched request, only valid once issued */
+	const TSharedPtr<FStreamableHandle>& GetHandle() const { return Handle; }
+
+	/** Calls the delegate once every one of the paths is loaded, the paths must outlive the waiter */
+	void AddWaiter(const void* Key, const TArray<FSoftObjectPath>& SoftObjectPaths, const FSimpleDelegate& Delegate);
+	void RemoveWaiter(const void* Key);
+
+	/** Called when a step stops waiting on the batch, paths nobody wants anymore are dropped if it hasn't been issued */
+	void ReleasePaths(const TArray<FSoftObjectPath>& SoftObjectPaths);
+
+private:
+	friend class FAsyncMixinAdmissionController;
+	friend class FAsyncMixinRequestCoalescer;
+
+	void Issue();
+
+	/** The pending paths plus their dependency closure, expanded once and reused until the pending paths change */
+	TArray<FSoftObjectPath>& GetExpandedPaths();
+	void NotifyWaiters();
+	void HandleUpdate(TSharedRef<FStreamableHandle> UpdatedHandle);
+	void HandleComplete();
+
+	/** Gives the in-flight budget back to the admission controller once the request is no longer loading */
+	void ReleaseAdmission();
+
+	struct FWaiter
+	{
+		const void* Key = nullptr;
+		const TArray<FSoftObjectPath>* SoftObjectPaths = nullptr;
+		FSimpleDelegate Delegate;
+	};
+
+	TAsyncLoadPriority Priority = 0;
+	bool bIssued = false;
+	double IssueTime = 0.0;
+
+	// Number of steps wanting each path, until the batch is issued
+	TMap<FSoftObjectPath, int32> PendingPaths;
+	TArray<FSoftObjectPath> ExpandedPaths;
+	bool bPathsExpanded = false;
+	TSharedPtr<FStreamableHandle> Handle;
+	TArray<FWaiter> Waiters;
+
+	// Set while the request counts against the admission controller's in-flight budget
+	bool bHoldsAdmission = false;
+	int64 AdmittedBytes = 0;
+};
+
+/**
+ * Collects the loads requested by every mix-in during a frame, de-duplicates them by path, and submits one batch per
+ * priority to the admission controller on the next tick.  Paths that are already loaded skip the coalescer, so they can
+ * still complete synchronously.
+ *
+ * Game thread only.
+ */
+class FAsyncMixinRequestCoalescer
+{
+public:
+	static FAsyncMixinRequestCoalescer& Get();
+
+	/** @return true if the paths should be batched, false if they should be requested right away */
+	bool ShouldCoalesce(const TArray<FSoftObjectPath>& SoftObjectPaths) const;
+
+	/** Adds the paths to this frame's batch for the priority */
+	TSharedRef<FAsyncMixinLoadBatch> Request(const TArray<FSoftObjectPath>& SoftObjectPaths, TAsyncLoadPriority Priority);
+
+	/** Submits the paths as a batch of their own right away, for loads that aren't coalesced but still need admission */
+	TSharedRef<FAsyncMixinLoadBatch> RequestNow(const TArray<FSoftObjectPath>& SoftObjectPaths, TAsyncLoadPriority Priority);
+
+	/** Submits every pending batch now */
+	void Flush();
+
+	/** Moves a pending batch whose priority was raised from OldPriority, so new requests at OldPriority get a batch of their own */
+	void Reprioritize(FAsyncMixinLoadBatch& Batch, TAsyncLoadPriority OldPriority);
+
+	/** Drops the pending batches without issuing them */
+	void Reset();
+
+	/** @return true if the object is loaded and not waiting on async loading to finish with it */
+	static bool IsFullyLoaded(const FSoftObjectPath& SoftObjectPath);
+
+private:
+	bool HandleFlushTick(float DeltaTime);
+	void RemoveFlushTicker();
+
+	TMap<TAsyncLoadPriority, TSharedRef<FAsyncMixinLoadBatch>> PendingBatches;
+
+	// Raised to a priority that already had a pending batch, they're submitted with the others but don't take requests
+	TArray<TSharedRef<FAsyncMixinLoadBatch>> DetachedBatches;
+
+	FTSTicker::FDelegateHandle FlushTickerHandle;
+};
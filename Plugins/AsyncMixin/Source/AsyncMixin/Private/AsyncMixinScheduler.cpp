@@ -0,0 +1,223 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinScheduler.h"
+
+#include "AsyncMixinStats.h"
+
+#include "Stats/Stats.h"
+
+FAsyncMixinScheduler& FAsyncMixinScheduler::Get()
+{
+	static FAsyncMixinScheduler Instance;
+	return Instance;
+}
+
+void FAsyncMixinScheduler::ScheduleStart(FLoadingState& State)
+{
+	check(IsInGameThread());
+
+	if (!State.StartNode.IsLinked())
+	{
+		State.StartNode.Element = &State;
+		State.StartNode.LinkBefore(StartQueue);
+		EnsureTicker();
+	}
+}
+
+void FAsyncMixinScheduler::ScheduleReap(FLoadingState& State)
+{
+	check(IsInGameThread());
+
+	if (!State.ReapNode.IsLinked())
+	{
+		State.ReapNode.Element = &State;
+		State.ReapNode.LinkBefore(ReapQueue);
+		EnsureTicker();
+	}
+}
+
+void FAsyncMixinScheduler::ScheduleDeadline(FAsyncStep& Step, double Deadline)
+{
+	check(IsInGameThread());
+
+	UnscheduleDeadline(Step);
+
+	// The wheel doesn't turn while it's empty, catch it up so the new deadline isn't measured from a stale slot.
+	if (NumDeadlines == 0)
+	{
+		WheelTime = FPlatformTime::Seconds();
+	}
+
+	const int64 Ticks = FMath::Max<int64>(1, FMath::CeilToInt64((Deadline - WheelTime) / DeadlineResolution));
+	const int32 Slot = (CurrentDeadlineSlot + Ticks) % NumDeadlineSlots;
+
+	Step.DeadlineRounds = static_cast<uint32>((Ticks - 1) / NumDeadlineSlots);
+	Step.DeadlineNode.Element = &Step;
+	Step.DeadlineNode.LinkBefore(DeadlineWheel[Slot]);
+	++NumDeadlines;
+
+	EnsureTicker();
+}
+
+void FAsyncMixinScheduler::UnscheduleDeadline(FAsyncStep& Step)
+{
+	if (Step.DeadlineNode.IsLinked())
+	{
+		Step.DeadlineNode.Unlink();
+		--Get().NumDeadlines;
+	}
+}
+
+void FAsyncMixinScheduler::ScheduleDrain(TSharedRef<FAsyncMixinRequestQueue, ESPMode::ThreadSafe> RequestQueue)
+{
+	DirtyRequestQueues.Enqueue(MoveTemp(RequestQueue));
+
+	if (!bRequestDrainScheduled.exchange(true))
+	{
+		AsyncMixinStats::AddActiveTickers(1);
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float DeltaTime)
+		{
+			FAsyncMixinScheduler::Get().DrainRequestQueues();
+			return false;
+		}));
+	}
+}
+
+void FAsyncMixinScheduler::DrainRequestQueues()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinScheduler_DrainRequestQueues);
+	check(IsInGameThread());
+
+	// Clear the flag first, anything pushed from here on schedules another drain.
+	bRequestDrainScheduled = false;
+	AsyncMixinStats::AddActiveTickers(-1);
+
+	TSharedPtr<FAsyncMixinRequestQueue, ESPMode::ThreadSafe> RequestQueue;
+	while (DirtyRequestQueues.Dequeue(RequestQueue))
+	{
+		RequestQueue->Drain();
+	}
+}
+
+void FAsyncMixinScheduler::Reset()
+{
+	DirtyRequestQueues.Empty();
+
+	while (StartQueue.IsLinked())
+	{
+		StartQueue.Next->Unlink();
+	}
+
+	while (ReapQueue.IsLinked())
+	{
+		ReapQueue.Next->Unlink();
+	}
+
+	for (FDeadlineNode& Slot : DeadlineWheel)
+	{
+		while (Slot.IsLinked())
+		{
+			Slot.Next->Unlink();
+		}
+	}
+	NumDeadlines = 0;
+
+	if (TickerHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(-1);
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+}
+
+void FAsyncMixinScheduler::EnsureTicker()
+{
+	if (!TickerHandle.IsValid())
+	{
+		AsyncMixinStats::AddActiveTickers(1);
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FAsyncMixinScheduler::Tick));
+	}
+}
+
+template <typename NodeType, typename ProcessType>
+void FAsyncMixinScheduler::DrainQueue(NodeType& Queue, ProcessType&& Process)
+{
+	if (!Queue.IsLinked())
+	{
+		return;
+	}
+
+	// Anything scheduled while we're processing goes into the real queue and waits for the next tick.  Elements removed
+	// while we're processing (e.g. destroyed by a user callback) unlink themselves from the local list.
+	NodeType Processing;
+	Processing.Next = Queue.Next;
+	Processing.Prev = Queue.Prev;
+	Processing.Next->Prev = &Processing;
+	Processing.Prev->Next = &Processing;
+	Queue.Next = &Queue;
+	Queue.Prev = &Queue;
+
+	while (Processing.IsLinked())
+	{
+		NodeType* Node = Processing.Next;
+		Node->Unlink();
+		Process(*Node->Element);
+	}
+}
+
+void FAsyncMixinScheduler::AdvanceDeadlineWheel(double Now)
+{
+	while ((NumDeadlines > 0) && (WheelTime + DeadlineResolution <= Now))
+	{
+		WheelTime += DeadlineResolution;
+		CurrentDeadlineSlot = (CurrentDeadlineSlot + 1) % NumDeadlineSlots;
+
+		FDeadlineNode& Slot = DeadlineWheel[CurrentDeadlineSlot];
+		DrainQueue(Slot, [this, &Slot](FAsyncStep& Step)
+		{
+			if (Step.DeadlineRounds > 0)
+			{
+				// Due on a later turn of the wheel.
+				--Step.DeadlineRounds;
+				Step.DeadlineNode.LinkBefore(Slot);
+				return;
+			}
+
+			--NumDeadlines;
+			Step.DeadlineState->HandleMissedDeadline(Step);
+		});
+	}
+
+	// Nothing left to time, the next deadline resets the wheel anyway.
+	if (NumDeadlines == 0)
+	{
+		WheelTime = Now;
+	}
+}
+
+bool FAsyncMixinScheduler::Tick(float DeltaTime)
+{
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinScheduler_Deadlines);
+		AdvanceDeadlineWheel(FPlatformTime::Seconds());
+	}
+
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinScheduler_Start);
+		DrainQueue(StartQueue, [](FLoadingState& State) { State.Start(); });
+	}
+
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinScheduler_Reap);
+		DrainQueue(ReapQueue, [](FLoadingState& State) { State.Reap(); });
+	}
+
+	if (StartQueue.IsLinked() || ReapQueue.IsLinked() || (NumDeadlines > 0))
+	{
+		return true;
+	}
+
+	AsyncMixinStats::AddActiveTickers(-1);
+	TickerHandle.Reset();
+	return false;
+}
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "AsyncMixin.h"
+
+/**
+ * Starts and releases the loading states of every mix-in from a single core ticker delegate, instead of each state
+ * adding its own ticker for both.  States are kept in intrusive queues, so scheduling doesn't allocate.
+ *
+ * Load deadlines are kept in a hashed timer wheel driven by the same ticker, steps link themselves into the slot their
+ * deadline falls in and unlink when their callback is called, so neither costs more than a couple of pointer writes.
+ *
+ * The ticker is only registered while a queue or the wheel has work.  Game thread only.
+ */
+class FAsyncMixinScheduler
+{
+public:
+	using FLoadingState = FAsyncMixin::FLoadingState;
+	using FQueueNode = FAsyncMixin::FLoadingState::FQueueNode;
+	using FAsyncStep = FAsyncMixin::FLoadingState::FAsyncStep;
+	using FDeadlineNode = FAsyncMixin::FLoadingState::TQueueNode<FAsyncStep>;
+
+	static FAsyncMixinScheduler& Get();
+
+	/** Starts the state next tick, unless it's started or unscheduled before then */
+	void ScheduleStart(FLoadingState& State);
+
+	/** Releases the state from its owner next tick, unless it's unscheduled before then */
+	void ScheduleReap(FLoadingState& State);
+
+	static void UnscheduleStart(FLoadingState& State) { State.StartNode.Unlink(); }
+	static void UnscheduleReap(FLoadingState& State) { State.ReapNode.Unlink(); }
+
+	static bool IsStartScheduled(const FLoadingState& State) { return State.StartNode.IsLinked(); }
+	static bool IsReapScheduled(const FLoadingState& State) { return State.ReapNode.IsLinked(); }
+
+	/** Calls the step's missed deadline handler once FPlatformTime::Seconds() passes Deadline, unless it's unscheduled before then */
+	void ScheduleDeadline(FAsyncStep& Step, double Deadline);
+
+	static void UnscheduleDeadline(FAsyncStep& Step);
+
+	/** Drains the request queue on the game thread, can be called from any thread */
+	void ScheduleDrain(TSharedRef<FAsyncMixinRequestQueue, ESPMode::ThreadSafe> RequestQueue);
+
+	/** Drops everything still queued */
+	void Reset();
+
+private:
+	FAsyncMixinScheduler() = default;
+
+	void EnsureTicker();
+	bool Tick(float DeltaTime);
+	void DrainRequestQueues();
+
+	/** Moves the queue to a local sentinel and unlinks its nodes one at a time, calling Process on each element */
+	template <typename NodeType, typename ProcessType>
+	static void DrainQueue(NodeType& Queue, ProcessType&& Process);
+
+	/** Turns the wheel up to Now, firing the deadlines of every slot it passes */
+	void AdvanceDeadlineWheel(double Now);
+
+	FQueueNode StartQueue;
+	FQueueNode ReapQueue;
+
+	static constexpr int32 NumDeadlineSlots = 256;
+	static constexpr double DeadlineResolution = 0.01;
+
+	// Slot N holds the deadlines due N ticks after the current slot, plus NumDeadlineSlots for each round they have
+	// left.  WheelTime is when the wheel was last turned to CurrentDeadlineSlot.
+	FDeadlineNode DeadlineWheel[NumDeadlineSlots];
+	int32 CurrentDeadlineSlot = 0;
+	double WheelTime = 0.0;
+	int32 NumDeadlines = 0;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	// Request queues with work in them, pushed from any thread.  Draining doesn't go through TickerHandle, the ticker is
+	// only touched on the game thread, so other threads add a one-shot delegate guarded by bRequestDrainScheduled.
+	TQueue<TSharedPtr<FAsyncMixinRequestQueue, ESPMode::ThreadSafe>, EQueueMode::Mpsc> DirtyRequestQueues;
+	std::atomic<bool> bRequestDrainScheduled = false;
+};
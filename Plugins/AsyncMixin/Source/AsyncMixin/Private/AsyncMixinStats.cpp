@@ -0,0 +1,244 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinStats.h"
+
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include <atomic>
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Time To First Callback (Avg ms)"), STAT_AsyncMixin_TimeToFirstCallback, STATGROUP_AsyncMixin);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total Latency (Avg ms)"), STAT_AsyncMixin_TotalLatency, STATGROUP_AsyncMixin);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Queue Wait (Avg ms)"), STAT_AsyncMixin_QueueWait, STATGROUP_AsyncMixin);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Load Time (Avg ms)"), STAT_AsyncMixin_LoadTime, STATGROUP_AsyncMixin);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Callback Wait (Avg ms)"), STAT_AsyncMixin_CallbackWait, STATGROUP_AsyncMixin);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Step Callbacks"), STAT_AsyncMixin_StepCallbacks, STATGROUP_AsyncMixin);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Deadline Misses"), STAT_AsyncMixin_DeadlineMisses, STATGROUP_AsyncMixin);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Preloaded Paths"), STAT_AsyncMixin_PreloadedPaths, STATGROUP_AsyncMixin);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Preloaded Paths Already Resident"), STAT_AsyncMixin_PreloadedPathsResident, STATGROUP_AsyncMixin);
+
+CSV_DEFINE_CATEGORY(AsyncMixin, true);
+
+TRACE_DECLARE_INT_COUNTER(AsyncMixin_LiveSteps, TEXT("AsyncMixin/LiveSteps"));
+TRACE_DECLARE_INT_COUNTER(AsyncMixin_ActiveTickers, TEXT("AsyncMixin/ActiveTickers"));
+TRACE_DECLARE_FLOAT_COUNTER(AsyncMixin_TotalLatency, TEXT("AsyncMixin/TotalLatencyMs"));
+TRACE_DECLARE_FLOAT_COUNTER(AsyncMixin_QueueWait, TEXT("AsyncMixin/QueueWaitMs"));
+TRACE_DECLARE_FLOAT_COUNTER(AsyncMixin_LoadTime, TEXT("AsyncMixin/LoadTimeMs"));
+TRACE_DECLARE_FLOAT_COUNTER(AsyncMixin_CallbackWait, TEXT("AsyncMixin/CallbackWaitMs"));
+TRACE_DECLARE_FLOAT_COUNTER(AsyncMixin_TimeToFirstCallback, TEXT("AsyncMixin/TimeToFirstCallbackMs"));
+TRACE_DECLARE_INT_COUNTER(AsyncMixin_DeadlineMisses, TEXT("AsyncMixin/DeadlineMisses"));
+
+namespace AsyncMixinStats
+{
+	struct FLatencyAggregate
+	{
+		uint64 Count = 0;
+		double SumMs = 0.0;
+		double MaxMs = 0.0;
+
+		double Add(double Ms)
+		{
+			++Count;
+			SumMs += Ms;
+			MaxMs = FMath::Max(MaxMs, Ms);
+			return SumMs / Count;
+		}
+
+		void Dump(FOutputDevice& Ar, const TCHAR* Name) const
+		{
+			Ar.Logf(TEXT("  %-24s count %8llu, avg %8.2f ms, max %8.2f ms"), Name, Count, Count > 0 ? SumMs / Count : 0.0, MaxMs);
+		}
+	};
+
+	struct FOwnerTimings
+	{
+		FName Name;
+		FLatencyAggregate TimeToFirstCallback;
+		FLatencyAggregate TotalLatency;
+		FLatencyAggregate QueueWait;
+		FLatencyAggregate LoadTime;
+		FLatencyAggregate CallbackWait;
+	};
+
+	static FLatencyAggregate TimeToFirstCallback;
+	static FLatencyAggregate TotalLatency;
+	static FLatencyAggregate QueueWait;
+	static FLatencyAggregate LoadTime;
+	static FLatencyAggregate CallbackWait;
+
+	// Keyed by the mix-in, only while it's alive.  Capped so a leak of mix-ins can't grow it without bound.
+	static constexpr int32 MaxTrackedOwners = 1024;
+	static constexpr int32 NumOwnersToDump = 10;
+	static TMap<const void*, FOwnerTimings> OwnerTimings;
+
+	static FOwnerTimings* FindOrAddOwner(const void* Owner, FName OwnerName)
+	{
+		FOwnerTimings* Timings = OwnerTimings.Find(Owner);
+		if ((Timings == nullptr) && (OwnerTimings.Num() < MaxTrackedOwners))
+		{
+			Timings = &OwnerTimings.Add(Owner);
+		}
+
+		if (Timings != nullptr)
+		{
+			Timings->Name = OwnerName;
+		}
+
+		return Timings;
+	}
+
+	static int32 LiveSteps = 0;
+	static std::atomic<int32> ActiveTickers = 0;
+	static uint64 DeadlinesScheduled = 0;
+	static uint64 DeadlineMisses = 0;
+	static uint64 Preloads = 0;
+	static uint64 PreloadsFullyResident = 0;
+
+	static FAutoConsoleCommandWithOutputDevice CmdDumpTimings(
+		TEXT("AsyncMixin.DumpTimings"),
+		TEXT("Prints the AsyncMixin latencies recorded since startup or the last AsyncMixin.ResetTimings."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+		{
+			Ar.Logf(TEXT("AsyncMixin timings (%d live steps, %d active tickers):"), LiveSteps, ActiveTickers.load());
+			TimeToFirstCallback.Dump(Ar, TEXT("Time to first callback"));
+			TotalLatency.Dump(Ar, TEXT("Total latency"));
+			QueueWait.Dump(Ar, TEXT("Queue wait"));
+			LoadTime.Dump(Ar, TEXT("Load time"));
+			CallbackWait.Dump(Ar, TEXT("Callback wait"));
+			Ar.Logf(TEXT("  %-24s count %8llu, missed %8llu (%.2f%%)"), TEXT("Deadlines"), DeadlinesScheduled, DeadlineMisses,
+				DeadlinesScheduled > 0 ? 100.0 * DeadlineMisses / DeadlinesScheduled : 0.0);
+			Ar.Logf(TEXT("  %-24s count %8llu, resident %7llu (%.2f%%)"), TEXT("Preloads"), Preloads, PreloadsFullyResident,
+				Preloads > 0 ? 100.0 * PreloadsFullyResident / Preloads : 0.0);
+
+			// Slowest first, by average total latency.
+			TArray<const TPair<const void*, FOwnerTimings>*> SortedOwners;
+			for (const TPair<const void*, FOwnerTimings>& Pair : OwnerTimings)
+			{
+				SortedOwners.Add(&Pair);
+			}
+			SortedOwners.Sort([](const TPair<const void*, FOwnerTimings>& A, const TPair<const void*, FOwnerTimings>& B)
+			{
+				const FLatencyAggregate& LatencyA = A.Value.TotalLatency;
+				const FLatencyAggregate& LatencyB = B.Value.TotalLatency;
+				return LatencyA.SumMs * FMath::Max<uint64>(LatencyB.Count, 1) > LatencyB.SumMs * FMath::Max<uint64>(LatencyA.Count, 1);
+			});
+
+			Ar.Logf(TEXT("AsyncMixin timings of the %d slowest of %d live mix-ins:"), FMath::Min(SortedOwners.Num(), NumOwnersToDump), SortedOwners.Num());
+			for (int32 OwnerIndex = 0; OwnerIndex < FMath::Min(SortedOwners.Num(), NumOwnersToDump); ++OwnerIndex)
+			{
+				const FOwnerTimings& Timings = SortedOwners[OwnerIndex]->Value;
+				Ar.Logf(TEXT(" [0x%p] %s"), SortedOwners[OwnerIndex]->Key, *Timings.Name.ToString());
+				Timings.TimeToFirstCallback.Dump(Ar, TEXT("Time to first callback"));
+				Timings.TotalLatency.Dump(Ar, TEXT("Total latency"));
+				Timings.QueueWait.Dump(Ar, TEXT("Queue wait"));
+				Timings.LoadTime.Dump(Ar, TEXT("Load time"));
+				Timings.CallbackWait.Dump(Ar, TEXT("Callback wait"));
+			}
+		}));
+
+	static FAutoConsoleCommand CmdResetTimings(
+		TEXT("AsyncMixin.ResetTimings"),
+		TEXT("Clears the AsyncMixin latencies."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			TimeToFirstCallback = FLatencyAggregate();
+			TotalLatency = FLatencyAggregate();
+			QueueWait = FLatencyAggregate();
+			LoadTime = FLatencyAggregate();
+			CallbackWait = FLatencyAggregate();
+			OwnerTimings.Reset();
+			DeadlinesScheduled = 0;
+			DeadlineMisses = 0;
+			Preloads = 0;
+			PreloadsFullyResident = 0;
+		}));
+
+	void RecordStepCallback(const void* Owner, FName OwnerName, const FStepTimeline& Timeline)
+	{
+		const double TotalLatencyMs = (Timeline.CallbackTime - Timeline.EnqueueTime) * 1000.0;
+		const double QueueWaitMs = (Timeline.IssueTime - Timeline.EnqueueTime) * 1000.0;
+		const double LoadTimeMs = (Timeline.CompleteTime - Timeline.IssueTime) * 1000.0;
+		const double CallbackWaitMs = (Timeline.CallbackTime - Timeline.CompleteTime) * 1000.0;
+
+		SET_FLOAT_STAT(STAT_AsyncMixin_TotalLatency, TotalLatency.Add(TotalLatencyMs));
+		SET_FLOAT_STAT(STAT_AsyncMixin_QueueWait, QueueWait.Add(QueueWaitMs));
+		SET_FLOAT_STAT(STAT_AsyncMixin_LoadTime, LoadTime.Add(LoadTimeMs));
+		SET_FLOAT_STAT(STAT_AsyncMixin_CallbackWait, CallbackWait.Add(CallbackWaitMs));
+		INC_DWORD_STAT(STAT_AsyncMixin_StepCallbacks);
+
+		TRACE_COUNTER_SET(AsyncMixin_TotalLatency, TotalLatencyMs);
+		TRACE_COUNTER_SET(AsyncMixin_QueueWait, QueueWaitMs);
+		TRACE_COUNTER_SET(AsyncMixin_LoadTime, LoadTimeMs);
+		TRACE_COUNTER_SET(AsyncMixin_CallbackWait, CallbackWaitMs);
+
+		if (FOwnerTimings* Timings = FindOrAddOwner(Owner, OwnerName))
+		{
+			Timings->TotalLatency.Add(TotalLatencyMs);
+			Timings->QueueWait.Add(QueueWaitMs);
+			Timings->LoadTime.Add(LoadTimeMs);
+			Timings->CallbackWait.Add(CallbackWaitMs);
+		}
+	}
+
+	void RecordFirstCallback(const void* Owner, FName OwnerName, double SequenceStartTime, double CallbackTime)
+	{
+		const double TimeToFirstCallbackMs = (CallbackTime - SequenceStartTime) * 1000.0;
+
+		SET_FLOAT_STAT(STAT_AsyncMixin_TimeToFirstCallback, TimeToFirstCallback.Add(TimeToFirstCallbackMs));
+		TRACE_COUNTER_SET(AsyncMixin_TimeToFirstCallback, TimeToFirstCallbackMs);
+
+		if (FOwnerTimings* Timings = FindOrAddOwner(Owner, OwnerName))
+		{
+			Timings->TimeToFirstCallback.Add(TimeToFirstCallbackMs);
+		}
+	}
+
+	void ForgetOwner(const void* Owner)
+	{
+		OwnerTimings.Remove(Owner);
+	}
+
+	void RecordDeadlineScheduled()
+	{
+		++DeadlinesScheduled;
+	}
+
+	void RecordDeadlineMiss()
+	{
+		++DeadlineMisses;
+
+		INC_DWORD_STAT(STAT_AsyncMixin_DeadlineMisses);
+		CSV_CUSTOM_STAT(AsyncMixin, DeadlineMisses, 1, ECsvCustomStatOp::Accumulate);
+		TRACE_COUNTER_SET(AsyncMixin_DeadlineMisses, DeadlineMisses);
+	}
+
+	void RecordPreload(int32 NumPaths, int32 NumMissing)
+	{
+		++Preloads;
+		if (NumMissing == 0)
+		{
+			++PreloadsFullyResident;
+		}
+
+		INC_DWORD_STAT_BY(STAT_AsyncMixin_PreloadedPaths, NumPaths);
+		INC_DWORD_STAT_BY(STAT_AsyncMixin_PreloadedPathsResident, NumPaths - NumMissing);
+	}
+
+	void AddLiveSteps(int32 Delta)
+	{
+		LiveSteps += Delta;
+		TRACE_COUNTER_SET(AsyncMixin_LiveSteps, LiveSteps);
+	}
+
+	void AddActiveTickers(int32 Delta)
+	{
+		const int32 NewActiveTickers = ActiveTickers.fetch_add(Delta) + Delta;
+		TRACE_COUNTER_SET(AsyncMixin_ActiveTickers, NewActiveTickers);
+	}
+
+	int32 GetActiveTickers()
+	{
+		return ActiveTickers.load();
+	}
+}
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("AsyncMixin"), STATGROUP_AsyncMixin, STATCAT_Advanced);
+
+/**
+ * Timing of the async loading sequences of every mix-in, aggregated into STATGROUP_AsyncMixin, trace counters visible
+ * in Insights, and AsyncMixin.DumpTimings, which also breaks them down per live mix-in.  Deadline misses also go to the
+ * AsyncMixin CSV category, so they show up in the CSV profiles perf reports and alerts are built from.
+ *
+ * Game thread only.
+ */
+namespace AsyncMixinStats
+{
+	/** Timestamps of a single load step, in FPlatformTime::Seconds */
+	struct FStepTimeline
+	{
+		// The step was requested from the mix-in
+		double EnqueueTime = 0.0;
+
+		// The streamable request covering the step was issued, later than enqueue for coalesced steps
+		double IssueTime = 0.0;
+
+		// The load completed, which may be well before the callback if an earlier step held it back
+		double CompleteTime = 0.0;
+
+		// The user callback was called
+		double CallbackTime = 0.0;
+	};
+
+	/** Records a load step whose callback is about to be called, globally and for the mix-in that requested it */
+	void RecordStepCallback(const void* Owner, FName OwnerName, const FStepTimeline& Timeline);
+
+	/** Records the first callback of a sequence, SequenceStartTime is when its first step was requested */
+	void RecordFirstCallback(const void* Owner, FName OwnerName, double SequenceStartTime, double CallbackTime);
+
+	/** Drops the timings of a mix-in that's being destroyed, so another one allocated at its address starts clean */
+	void ForgetOwner(const void* Owner);
+
+	/** Records a load that was given a deadline */
+	void RecordDeadlineScheduled();
+
+	/** Records a load whose deadline passed before its callback was called, also counted in the AsyncMixin CSV category */
+	void RecordDeadlineMiss();
+
+	/** Records a bundle preload, NumMissing of its NumPaths paths weren't resident yet */
+	void RecordPreload(int32 NumPaths, int32 NumMissing);
+
+	/** Tracks the number of steps that are allocated, for the trace counter */
+	void AddLiveSteps(int32 Delta);
+
+	/** Tracks the number of core tickers AsyncMixin has registered, any thread */
+	void AddActiveTickers(int32 Delta);
+	int32 GetActiveTickers();
+}
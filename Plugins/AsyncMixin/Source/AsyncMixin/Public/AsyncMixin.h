@@ -0,0 +1,1128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/PrimaryAssetId.h"
+#include "UObject/SoftObjectPtr.h"
+#include "UObject/StrongObjectPtr.h"
+
+#include <atomic>
+
+class AActor;
+class FAsyncCondition;
+class FAsyncMixinLoadAwaiter;
+class FAsyncMixinLoadBatch;
+class FAsyncMixinRequestQueue;
+class FName;
+class UPrimaryDataAsset;
+class UWorld;
+struct FPrimaryAssetId;
+struct FStreamableHandle;
+template <class TClass>
+class TSubclassOf;
+template <typename T>
+class TAsyncMixinClassAwaiter;
+template <typename T>
+class TAsyncMixinObjectAwaiter;
+
+DECLARE_DELEGATE_OneParam(FStreamableHandleDelegate, TSharedPtr<FStreamableHandle>)
+
+/**
+ * What happens to the assets of completed loads once the FAsyncMixin that requested them no longer needs them.
+ */
+/**
+ * 当请求资源的 FAsyncMixin 不再需要它们时，已完成加载的资源会如何处理。
+ */
+enum class EAsyncMixinRetentionPolicy : uint8
+{
+	// Handles from AsyncLoad are released with the loading state, preloaded bundles stay until they're canceled.
+	// AsyncLoad 的句柄随加载状态一起释放，预加载的捆绑包会一直保留直到被取消。
+	Default,
+
+	// Completed loads are handed to a shared LRU cache that keeps them resident, and evicts the least recently used
+	// loads once their estimated size goes over AsyncMixin.HandleCache.BudgetMB.  Useful for lists that get scrolled
+	// back and forth over the same icons.
+	// 完成的加载会交给一个共享的 LRU 缓存并保持常驻，当它们的估计大小超过 AsyncMixin.HandleCache.BudgetMB 时，
+	// 会逐出最近最少使用的加载。适用于来回滚动显示相同图标的列表。
+	KeepResidentUntilEvicted
+};
+
+/**
+ * How the FAsyncMixin calls back into user code as the steps of an async sequence complete.
+ */
+/**
+ * 异步序列的步骤完成时，FAsyncMixin 如何回调用户代码。
+ */
+enum class EAsyncMixinCompletionMode : uint8
+{
+	// Callbacks are called in the order the steps were requested, a slow step holds back every step after it.
+	// 按照请求步骤的顺序调用回调，一个慢的步骤会阻塞其后的所有步骤。
+	InOrder,
+
+	// Each load calls back as soon as it completes.  AsyncEvent and AsyncCondition steps are barriers, they only call
+	// back once everything requested before them has, and nothing requested after them calls back before they do.
+	// 每个加载在完成后立即回调。AsyncEvent 和 AsyncCondition 步骤是屏障，只有在它们之前请求的所有内容都回调后它们才会回调，
+	// 并且在它们之后请求的内容都不会在它们之前回调。
+	OutOfOrder
+};
+
+/**
+ * A latency budget for a single AsyncLoad.  If the load's callback hasn't been called Seconds after the load was
+ * requested, OnMissed is called so the caller can show a placeholder.  The load carries on, and its callback is still
+ * called once it completes, so the placeholder can be swapped for the real asset.  Misses are counted in
+ * STATGROUP_AsyncMixin, the AsyncMixin CSV category and AsyncMixin.DumpTimings.
+ */
+/**
+ * 单个 AsyncLoad 的延迟预算。如果在请求加载 Seconds 秒后仍未调用加载的回调，就会调用 OnMissed，
+ * 以便调用者显示占位内容。加载会继续进行，完成后仍会调用其回调，因此可以用真正的资源替换占位内容。
+ * 超时次数会统计在 STATGROUP_AsyncMixin、AsyncMixin CSV 分类和 AsyncMixin.DumpTimings 中。
+ */
+struct FAsyncLoadDeadline
+{
+	FAsyncLoadDeadline() = default;
+
+	FAsyncLoadDeadline(float InSeconds, const FSimpleDelegate& InOnMissed)
+		: Seconds(InSeconds)
+		, OnMissed(InOnMissed)
+	{
+	}
+
+	FAsyncLoadDeadline(float InSeconds, TFunction<void()>&& InOnMissed)
+		: Seconds(InSeconds)
+		, OnMissed(FSimpleDelegate::CreateLambda(MoveTemp(InOnMissed)))
+	{
+	}
+
+	/** A deadline of zero or less is no deadline. */
+	/** 小于或等于零的截止时间表示没有截止时间。 */
+	bool IsSet() const { return Seconds > 0.0f; }
+
+	/** Seconds from the request until OnMissed is called, resolved in steps of 10ms. */
+	/** 从请求到调用 OnMissed 的秒数，精度为 10 毫秒。 */
+	float Seconds = 0.0f;
+
+	FSimpleDelegate OnMissed;
+};
+
+/**
+ * The FAsyncMixin allows easier management of async loading requests, to ensure linear request handling, to make 
+ * writing code much easier.  The usage pattern is as follows,
+ *
+ * First - inherit from FAsyncMixin, even if you're a UObject, you can also inherit from FAsyncMixin.
+ *
+ * Then - you can make your async loads as follows.
+ * 
+ * CancelAsyncLoading();			// Some objects get reused like in lists, so it's important to cancel anything you had pending doesn't complete.
+ * AsyncLoad(ItemOne, CallbackOne);
+ * AsyncLoad(ItemTwo, CallbackTwo);
+ * StartAsyncLoading();
+ * 
+ * You can also include the 'this' scope safely, one of the benefits of the mix-in, is that none of the callbacks
+ * are ever out of scope of the host AsyncMixin derived object.
+ * e.g.
+ * AsyncLoad(SomeSoftObjectPtr, [this, ...]() {
+ *    
+ * });
+ * 
+ *
+ * What will happen is first we cancel any existing one(s), e.g. perhaps we are a widget that just got told to represent
+ * some new thing.  What will happen is we'll Load ItemOne and ItemTwo, *THEN* we'll call the callbacks in the order you
+ * requested the async loads - even if ItemOne or ItemTwo was already loaded when you request it.
+ *
+ * When all the async loading requests complete, OnFinishedLoading will be called.
+ *
+ * If the steps are independent (e.g. the icons of a list row), override GetAsyncLoadingCompletionMode() to return
+ * EAsyncMixinCompletionMode::OutOfOrder, and each callback will be called as soon as its own load completes.
+ * 
+ * If you forget to call StartAsyncLoading(), we'll call it next frame, but you should remember to call it
+ * when you're done with your setup, as maybe everything is already loaded, and it will avoid a single frame
+ * of a loading indicator flash, which is annoying.
+ * 
+ * NOTE: The FAsyncMixin also makes it safe to pass [this] as a captured input into your lambda, because it handles 
+ * unhooking everything if either your owner class is destroyed, or you cancel everything.
+ *
+ * NOTE: FAsyncMixin only adds a single shared pointer to your class.  Several classes currently handling async loading 
+ * internally allocate TSharedPtr<FStreamableHandle> members and tend to hold onto SoftObjectPaths temporary state.  The 
+ * FAsyncMixin does all of this internally in a loading state that is only allocated while there is async work, and is
+ * recycled through a small pool when it's released, so that all of the async request memory is stored temporarily
+ * and sparsely.  Mix-ins that take requests from other threads hold a second pointer, to their FAsyncMixinRequestQueue.
+ * 
+ * NOTE: Loads of paths that aren't loaded yet are batched with the requests of every other mix-in made during the
+ * same frame, and issued as one streamable request at the end of it.  Set AsyncMixin.CoalesceRequests 0 to request
+ * them right away.  Either way requests are only issued while the AsyncMixin layer is under its in-flight budget
+ * (AsyncMixin.Admission.MaxInFlightRequests and MaxInFlightMB), the rest wait their turn in priority order.
+ * 
+ * NOTE: Sequences can also be written as coroutines with AsyncLoadAwait, see AsyncMixinCoroutine.h.
+ * 
+ * NOTE: Loads can be given a FAsyncLoadDeadline, e.g. to show a placeholder icon if the real one takes too long.
+ * 
+ * NOTE: Actor classes loaded with AsyncLoadAndPrewarm have instances constructed ahead of time, see UAsyncMixinActorPool.
+ * 
+ * NOTE: For debugging and understanding what's going on, you should add -LogCmds="LogAsyncMixin Verbose" to the command line.
+ */
+/**
+ * FAsyncMixin 使异步加载请求的管理更加容易，以确保线性请求处理，使编写代码更加容易。使用模式如下：
+ *
+ * 首先，即使您是 UObject，也应从 FAsyncMixin 继承，您也可以从 FAsyncMixin 继承。
+ *
+ * 然后，您可以按以下方式进行异步加载。
+ * 
+ * CancelAsyncLoading();			// 有些对象会像在列表中一样被重复使用，因此取消任何未完成的挂起操作非常重要。
+ * AsyncLoad(ItemOne, CallbackOne);
+ * AsyncLoad(ItemTwo, CallbackTwo);
+ * StartAsyncLoading();
+ * 
+ * 您还可以安全地包含“this”作用域，混合的一个好处是，没有一个回调函数会超出主 AsyncMixin 派生对象的范围。
+ * 例如：
+ * AsyncLoad(SomeSoftObjectPtr, this, ... {
+ *    
+ * });
+ * 
+ *
+ * 首先，我们将取消任何现有的操作，例如，可能是一个小部件，刚刚被告知要表示某个新事物。然后，我们将加载 ItemOne 和 ItemTwo，然后按您请求异步加载的顺序调用回调函数，即使在请求它时 ItemOne 或 ItemTwo 已经加载。
+ *
+ * 当所有异步加载请求完成时，将调用 OnFinishedLoading。
+ *
+ * 如果各个步骤相互独立（例如列表行的图标），可以重写 GetAsyncLoadingCompletionMode() 并返回
+ * EAsyncMixinCompletionMode::OutOfOrder，这样每个回调都会在其自己的加载完成后立即被调用。
+ * 
+ * 如果您忘记调用 StartAsyncLoading()，我们将在下一帧调用它，但您应该在完成设置时记得调用它，因为可能已经加载了所有内容，这将避免加载指示器闪烁一帧，这很烦人。
+ * 
+ * 注意：FAsyncMixin 还使得将 [this] 作为捕获输入传递到 lambda 中变得安全，因为它处理了所有取消操作。
+ *
+ * 注意： FAsyncMixin 只会向您的类添加一个共享指针。目前，几个类在内部处理异步加载时会分配 TSharedPtr<FStreamableHandle> 成员，并倾向于保留 SoftObjectPaths 的临时状态。FAsyncMixin 在一个仅在存在异步工作时才分配的加载状态中完成所有这些操作，该状态释放时会通过一个小池回收，因此所有异步请求内存都是临时和稀疏存储的。从其他线程接受请求的混合对象会持有第二个指针，指向它们的 FAsyncMixinRequestQueue。
+ * 
+ * 注意：尚未加载的路径会与同一帧内所有其他混合对象的请求合并，并在帧结束时作为一个流式请求发出。
+ * 设置 AsyncMixin.CoalesceRequests 0 可以立即请求它们。无论哪种方式，只有当 AsyncMixin 层低于其进行中预算
+ * （AsyncMixin.Admission.MaxInFlightRequests 和 MaxInFlightMB）时才会发出请求，其余请求按优先级顺序排队等待。
+ * 
+ * 注意：序列也可以使用 AsyncLoadAwait 编写为协程，参见 AsyncMixinCoroutine.h。
+ * 
+ * 注意：可以为加载指定 FAsyncLoadDeadline，例如当真正的图标加载太久时显示占位图标。
+ * 
+ * 注意：使用 AsyncLoadAndPrewarm 加载的 Actor 类会提前构造实例，参见 UAsyncMixinActorPool。
+ * 
+ * 请注意，为了调试和了解正在发生的情况，您应该在命令行中添加 -LogCmds="LogAsyncMixin Verbose"。
+ */
+class ASYNCMIXIN_API FAsyncMixin : public FNoncopyable
+{
+protected:
+	FAsyncMixin();
+
+public:
+	virtual ~FAsyncMixin();
+
+	/** Number of core tickers registered by AsyncMixin across every mix-in, for load tests to check against a baseline. */
+	/** AsyncMixin 在所有混合对象中注册的核心 Ticker 数量，供负载测试与基线比较。 */
+	static int32 GetNumActiveTickers();
+
+protected:
+	/** Called when loading starts. */
+	virtual void OnStartedLoading()
+	{
+	}
+
+	/** Called when all loading has finished. */
+	virtual void OnFinishedLoading()
+	{
+	}
+
+	/** Whether callbacks must be called in request order, or as soon as each of their loads completes. */
+	/** 回调是必须按请求顺序调用，还是在各自的加载完成后立即调用。 */
+	virtual EAsyncMixinCompletionMode GetAsyncLoadingCompletionMode() const
+	{
+		return EAsyncMixinCompletionMode::InOrder;
+	}
+
+	/** Whether completed loads are released with the loading state, or kept resident in the shared handle cache. */
+	/** 完成的加载是随加载状态一起释放，还是保持常驻在共享的句柄缓存中。 */
+	virtual EAsyncMixinRetentionPolicy GetAsyncLoadingRetentionPolicy() const
+	{
+		return EAsyncMixinRetentionPolicy::Default;
+	}
+
+	/**
+	 * Groups the loads of this mix-in with those of similar mix-ins for access-pattern prefetching, e.g. the class name
+	 * of a UObject owner.  Paths requested under the same key are recorded as one sequence, and the paths that usually
+	 * follow a completed load are prefetched at a low priority.  None opts out.  Only used with AsyncMixin.Prefetch.Enable.
+	 */
+	/**
+	 * 用于访问模式预取，将此混合对象的加载与相似混合对象的加载归为一组，例如 UObject 拥有者的类名。
+	 * 在同一键下请求的路径会被记录为一个序列，并以低优先级预取通常跟随在已完成加载之后的路径。
+	 * None 表示不参与。仅在设置 AsyncMixin.Prefetch.Enable 时使用。
+	 */
+	virtual FName GetAsyncLoadingAccessKey() const
+	{
+		return NAME_None;
+	}
+
+protected:
+	/** Async load a TSoftClassPtr<T>, call the Callback when complete. */
+	/** 异步加载 TSoftClassPtr<T>，在完成时调用 Callback。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftClassPtr<T> SoftClass, TFunction<void()>&& Callback, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftClass.ToSoftObjectPath(), FSimpleDelegate::CreateLambda(MoveTemp(Callback)), Priority);
+	}
+
+	/** Async load a TSoftClassPtr<T>, call the Callback when complete. */
+	/** 异步加载 TSoftClassPtr<T>，在完成时调用 Callback。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftClassPtr<T> SoftClass, TFunction<void(TSubclassOf<T>)>&& Callback, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftClass.ToSoftObjectPath(),
+		          FSimpleDelegate::CreateLambda([SoftClass, UserCallback = MoveTemp(Callback)]() mutable
+		          {
+			          UserCallback(SoftClass.Get());
+		          }),
+		          Priority
+		);
+	}
+
+	/** Async load a TSoftClassPtr<T>, call the Callback when complete. */
+	/** 异步加载 TSoftClassPtr<T>，在完成时调用 Callback。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftClassPtr<T> SoftClass, const FSimpleDelegate& Callback = FSimpleDelegate(), TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftClass.ToSoftObjectPath(), Callback, Priority);
+	}
+
+	/** Async load a TSoftObjectPtr<T>, call the Callback when complete. */
+	/** 异步加载 TSoftObjectPtr<T>，在完成时调用 Callback。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftObjectPtr<T> SoftObject, TFunction<void()>&& Callback, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftObject.ToSoftObjectPath(), FSimpleDelegate::CreateLambda(MoveTemp(Callback)), Priority);
+	}
+
+	/** Async load a TSoftObjectPtr<T>, call the Callback when complete. */
+	/** 异步加载 TSoftObjectPtr<T>，在完成时调用 Callback。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftObjectPtr<T> SoftObject, TFunction<void(T*)>&& Callback, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftObject.ToSoftObjectPath(),
+		          FSimpleDelegate::CreateLambda([SoftObject, UserCallback = MoveTemp(Callback)]() mutable
+		          {
+			          UserCallback(SoftObject.Get());
+		          }),
+		          Priority
+		);
+	}
+
+	/** Async load a TSoftObjectPtr<T>, call the Callback when complete. */
+	/** 异步加载 TSoftObjectPtr<T>，在完成时调用 Callback。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftObjectPtr<T> SoftObject, const FSimpleDelegate& Callback = FSimpleDelegate(), TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftObject.ToSoftObjectPath(), Callback, Priority);
+	}
+
+	/** Async load a FSoftObjectPath, call the Callback when complete. */
+	/** 异步加载 FSoftObjectPath，在完成时调用 Callback。 */
+	void AsyncLoad(FSoftObjectPath SoftObjectPath, const FSimpleDelegate& Callback = FSimpleDelegate(), TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Async load an array of FSoftObjectPath, call the Callback when complete. */
+	/** 异步加载 FSoftObjectPath 数组，在完成时调用 Callback。 */
+	void AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, TFunction<void()>&& Callback, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftObjectPaths, FSimpleDelegate::CreateLambda(MoveTemp(Callback)), Priority);
+	}
+
+	/** Async load an array of FSoftObjectPath, call the Callback when complete. */
+	/** 异步加载 FSoftObjectPath 数组，在完成时调用 Callback。 */
+	void AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, const FSimpleDelegate& Callback = FSimpleDelegate(), TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Async load a TSoftObjectPtr<T>, call the Callback when complete, and the deadline's OnMissed if it's late. */
+	/** 异步加载 TSoftObjectPtr<T>，在完成时调用 Callback，如果超过截止时间则调用其 OnMissed。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftObjectPtr<T> SoftObject, const FAsyncLoadDeadline& Deadline, TFunction<void(T*)>&& Callback,
+	               TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftObject.ToSoftObjectPath(),
+		          Deadline,
+		          FSimpleDelegate::CreateLambda([SoftObject, UserCallback = MoveTemp(Callback)]() mutable
+		          {
+			          UserCallback(SoftObject.Get());
+		          }),
+		          Priority
+		);
+	}
+
+	/** Async load a TSoftClassPtr<T>, call the Callback when complete, and the deadline's OnMissed if it's late. */
+	/** 异步加载 TSoftClassPtr<T>，在完成时调用 Callback，如果超过截止时间则调用其 OnMissed。 */
+	template <typename T = UObject>
+	void AsyncLoad(TSoftClassPtr<T> SoftClass, const FAsyncLoadDeadline& Deadline, TFunction<void(TSubclassOf<T>)>&& Callback,
+	               TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoad(SoftClass.ToSoftObjectPath(),
+		          Deadline,
+		          FSimpleDelegate::CreateLambda([SoftClass, UserCallback = MoveTemp(Callback)]() mutable
+		          {
+			          UserCallback(SoftClass.Get());
+		          }),
+		          Priority
+		);
+	}
+
+	/** Async load a FSoftObjectPath, call the Callback when complete, and the deadline's OnMissed if it's late. */
+	/** 异步加载 FSoftObjectPath，在完成时调用 Callback，如果超过截止时间则调用其 OnMissed。 */
+	void AsyncLoad(FSoftObjectPath SoftObjectPath, const FAsyncLoadDeadline& Deadline, const FSimpleDelegate& Callback,
+	               TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Async load an array of FSoftObjectPath, call the Callback when complete, and the deadline's OnMissed if it's late. */
+	/** 异步加载 FSoftObjectPath 数组，在完成时调用 Callback，如果超过截止时间则调用其 OnMissed。 */
+	void AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, const FAsyncLoadDeadline& Deadline, const FSimpleDelegate& Callback,
+	               TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/**
+	 * Async load an actor class, then construct Count pooled instances of it in the world's UAsyncMixinActorPool, a few
+	 * per frame.  The Callback is called once the class is loaded and the pool is warm, spawn the actors with
+	 * UAsyncMixinActorPool::SpawnActor so the first ones don't hitch on constructing their components.
+	 */
+	/**
+	 * 异步加载一个 Actor 类，然后在世界的 UAsyncMixinActorPool 中每帧构造几个，共 Count 个池化实例。
+	 * 在类加载完成且池已预热后调用 Callback，使用 UAsyncMixinActorPool::SpawnActor 生成 Actor，
+	 * 这样前几个 Actor 就不会因为构造组件而卡顿。
+	 */
+	template <typename T = AActor>
+	void AsyncLoadAndPrewarm(UWorld* World, TSoftClassPtr<T> SoftClass, int32 Count, TFunction<void(TSubclassOf<T>)>&& Callback,
+	                         TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority)
+	{
+		AsyncLoadAndPrewarm(World,
+		                    SoftClass.ToSoftObjectPath(),
+		                    Count,
+		                    FSimpleDelegate::CreateLambda([SoftClass, UserCallback = MoveTemp(Callback)]() mutable
+		                    {
+			                    UserCallback(SoftClass.Get());
+		                    }),
+		                    Priority
+		);
+	}
+
+	/** Async load an actor class and prewarm Count pooled instances of it, call the Callback once the pool is warm. */
+	/** 异步加载一个 Actor 类并预热 Count 个池化实例，在池预热完成后调用 Callback。 */
+	void AsyncLoadAndPrewarm(UWorld* World, const FSoftObjectPath& ActorClassPath, int32 Count, const FSimpleDelegate& Callback = FSimpleDelegate(),
+	                         TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/**
+	 * Awaitable load of a TSoftObjectPtr<T> for coroutines, resumes with the loaded object.  Defined in AsyncMixinCoroutine.h.
+	 *
+	 *    UTexture2D* Icon = co_await AsyncLoadAwait(IconPtr);
+	 */
+	/**
+	 * 供协程使用的 TSoftObjectPtr<T> 可等待加载，恢复时返回已加载的对象。定义在 AsyncMixinCoroutine.h 中。
+	 *
+	 *    UTexture2D* Icon = co_await AsyncLoadAwait(IconPtr);
+	 */
+	template <typename T = UObject>
+	TAsyncMixinObjectAwaiter<T> AsyncLoadAwait(TSoftObjectPtr<T> SoftObject, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Awaitable load of a TSoftClassPtr<T> for coroutines, resumes with the loaded class.  Defined in AsyncMixinCoroutine.h. */
+	/** 供协程使用的 TSoftClassPtr<T> 可等待加载，恢复时返回已加载的类。定义在 AsyncMixinCoroutine.h 中。 */
+	template <typename T = UObject>
+	TAsyncMixinClassAwaiter<T> AsyncLoadAwait(TSoftClassPtr<T> SoftClass, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Awaitable load of an array of FSoftObjectPath for coroutines.  Defined in AsyncMixinCoroutine.h. */
+	/** 供协程使用的 FSoftObjectPath 数组可等待加载。定义在 AsyncMixinCoroutine.h 中。 */
+	FAsyncMixinLoadAwaiter AsyncLoadAwait(const TArray<FSoftObjectPath>& SoftObjectPaths, TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Given an array of primary assets, it loads all of the bundles referenced by properties of these assets specified in the LoadBundles array. */
+	/** 给定一个主资产数组，它会加载在 LoadBundles 数组中指定的这些资产的属性引用的所有捆绑包。 */
+	template <typename T = UPrimaryDataAsset>
+	void AsyncPreloadPrimaryAssetsAndBundles(const TArray<T*>& Assets, const TArray<FName>& LoadBundles,
+	                                         const FSimpleDelegate& Callback = FSimpleDelegate(), TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		for (const T* Item : Assets)
+		{
+			PrimaryAssetIds.Add(Item);
+		}
+
+		AsyncPreloadPrimaryAssetsAndBundles(PrimaryAssetIds, LoadBundles, Callback, Priority);
+	}
+
+	/** Given an array of primary asset ids, it loads all of the bundles referenced by properties of these assets specified in the LoadBundles array. */
+	/** 给定一个主资产 ID 数组，它会加载在 LoadBundles 数组中指定的这些资产的属性引用的所有捆绑包。 */
+	void AsyncPreloadPrimaryAssetsAndBundles(const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& LoadBundles, TFunction<void()>&& Callback,
+	                                         TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority)
+	{
+		AsyncPreloadPrimaryAssetsAndBundles(AssetIds, LoadBundles, FSimpleDelegate::CreateLambda(MoveTemp(Callback)), Priority);
+	}
+
+	/**
+	 * Given an array of primary asset ids, it loads all of the bundles referenced by properties of these assets specified in the LoadBundles array.
+	 * Only the paths that aren't resident yet are read, if everything is already loaded the step is complete as soon as it's added.
+	 * Like UAssetManager::PreloadPrimaryAssets, bundles load at the default priority, pass AsyncLoadHighPriority to raise them.
+	 */
+	/**
+	 * 给定一个主资产 ID 数组，它会加载在 LoadBundles 数组中指定的这些资产的属性引用的所有捆绑包。
+	 * 只会读取尚未常驻的路径，如果所有内容都已加载，则步骤在添加后立即完成。
+	 * 与 UAssetManager::PreloadPrimaryAssets 一样，捆绑包以默认优先级加载，传入 AsyncLoadHighPriority 可以提高优先级。
+	 */
+	void AsyncPreloadPrimaryAssetsAndBundles(const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& LoadBundles,
+	                                         const FSimpleDelegate& Callback = FSimpleDelegate(), TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+	/** Add a future condition that must be true before we move forward. */
+	/** 添加一个必须为真的未来条件，然后我们才能继续。 */
+	void AsyncCondition(TSharedRef<FAsyncCondition> Condition, const FSimpleDelegate& Callback = FSimpleDelegate());
+
+	/**
+	 * Rather than load anything, this callback is just inserted into the callback sequence so that when async loading 
+	 * completes this event will be called at the same point in the sequence.  Super useful if you don't want a step to be
+	 * tied to a particular asset in case some of the assets are optional.
+	 */
+	/**
+	 * 不是加载任何内容，此回调函数仅插入到回调序列中，以便在异步加载完成时，在序列中的相同点调用此事件。如果您不想将步骤与特定资产绑定在一起，这将非常有用，因为某些资产是可选的。
+	 */
+	void AsyncEvent(TFunction<void()>&& Callback)
+	{
+		AsyncEvent(FSimpleDelegate::CreateLambda(MoveTemp(Callback)));
+	}
+
+	/**
+	 * Rather than load anything, this callback is just inserted into the callback sequence so that when async loading
+	 * completes this event will be called at the same point in the sequence.  Super useful if you don't want a step to be
+	 * tied to a particular asset in case some of the assets are optional.
+	 */
+	/**
+	 * 这个回调并不加载任何东西，而是插入到回调序列中，这样当异步加载完成时，
+	 * 这个事件将在序列中的相同点被调用。如果你不希望一个步骤绑定到特定的资产，
+	 * 特别是当一些资产是可选的，这将非常有用。
+	 */
+	void AsyncEvent(const FSimpleDelegate& Callback);
+
+	/** Flushes any async loading requests. */
+	/** 刷新任何异步加载请求。 */
+	void StartAsyncLoading();
+
+	/** Cancels any pending async loads. */
+	/** 取消任何待处理的异步加载。 */
+	void CancelAsyncLoading();
+
+	/** Is async loading current in progress? */
+	/** 当前是否正在进行异步加载？ */
+	bool IsAsyncLoadingInProgress() const;
+
+	/**
+	 * Changes the priority of every load this mix-in has queued or in flight, e.g. raise it for a list entry that
+	 * just scrolled into view.  The package loader only ever raises the priority of packages that are already in
+	 * flight, so lowering the priority is remembered by the steps but won't slow down packages already requested.
+	 * Loads requested after this call use the priority passed to them.
+	 */
+	/**
+	 * 更改此混合对象已排队或正在进行的所有加载的优先级，例如为刚刚滚动到视图中的列表条目提高优先级。
+	 * 包加载器只会提高已经在进行中的包的优先级，因此降低优先级会被步骤记录，但不会减慢已经请求的包。
+	 * 此调用之后请求的加载使用传递给它们的优先级。
+	 */
+	void SetAsyncLoadingPriority(TAsyncLoadPriority Priority);
+
+	/**
+	 * Returns the queue other threads can use to request loads for this mix-in, see FAsyncMixinRequestQueue.  The queue
+	 * is created the first time it's asked for, and stops accepting requests once the mix-in is destroyed.
+	 */
+	/**
+	 * 返回其他线程可用于为此混合对象请求加载的队列，参见 FAsyncMixinRequestQueue。队列在第一次被请求时创建，
+	 * 并在混合对象销毁后停止接受请求。
+	 */
+	TSharedRef<FAsyncMixinRequestQueue, ESPMode::ThreadSafe> GetAsyncRequestQueue();
+
+private:
+	/**
+	 * The FLoadingState is what actually is allocated for the FAsyncMixin, so that the FAsyncMixin itself only holds a
+	 * pointer to it, and we dynamically create the FLoadingState only if needed, and release it back to the pool when
+	 * it's unneeded.
+	 */
+	/**
+	 * FLoadingState 是实际为 FAsyncMixin 分配的内容，这样 FAsyncMixin 本身只持有一个指向它的指针，
+	 * 我们只在需要时动态创建 FLoadingState，并在不需要时将其释放回池中。
+	 */
+	class FLoadingState : public TSharedFromThis<FLoadingState>
+	{
+	public:
+		FLoadingState(FAsyncMixin& InOwner);
+		virtual ~FLoadingState();
+
+		/** Cancels everything and clears the owner, nothing will call back into the previous owner after this. */
+		/** 取消所有内容并清除拥有者，此后不会再回调之前的拥有者。 */
+		void DetachFromOwner();
+
+		/** Frees the memory of cancelled steps so a detached state can be handed to another mix-in. */
+		/** 释放已取消步骤的内存，以便已分离的状态可以交给另一个混合对象。 */
+		void ResetForReuse();
+
+		/** Hands a pooled state to a new owner. */
+		/** 将池中的状态交给新的拥有者。 */
+		void SetOwner(FAsyncMixin& InOwner);
+
+		/** Starts the async sequence. */
+		/** 开始异步序列。 */
+		void Start();
+
+		/** Cancels the async sequence. */
+		/** 取消异步序列。 */
+		void CancelAndDestroy();
+
+		void AsyncLoad(FSoftObjectPath SoftObject, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority,
+		               const FAsyncLoadDeadline& Deadline = FAsyncLoadDeadline());
+		void AsyncLoad(const TArray<FSoftObjectPath>& SoftObjectPaths, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority,
+		               const FAsyncLoadDeadline& Deadline = FAsyncLoadDeadline());
+		void AsyncPreloadPrimaryAssetsAndBundles(const TArray<FPrimaryAssetId>& PrimaryAssetIds, const TArray<FName>& LoadBundles,
+		                                         const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority);
+
+		/** Loads the paths and resumes the suspended coroutine in place of a callback, the coroutine is destroyed if the load is canceled. */
+		/** 加载路径并以恢复挂起的协程代替回调，如果加载被取消，协程会被销毁。 */
+		void AsyncLoadAndResume(TArray<FSoftObjectPath>&& SoftObjectPaths, void* CoroutineAddress, TAsyncLoadPriority Priority);
+
+		/** Loads the paths without waiting for this frame's batch, for requests from other threads that already waited a tick to get here. */
+		/** 加载路径而不等待本帧的批次，用于来自其他线程、已经等待了一次 tick 才到达这里的请求。 */
+		void AsyncLoadNow(TArray<FSoftObjectPath>&& SoftObjectPaths, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority);
+
+		void SetPriority(TAsyncLoadPriority Priority);
+		void AsyncCondition(TSharedRef<FAsyncCondition> Condition, const FSimpleDelegate& Callback);
+		void AsyncEvent(const FSimpleDelegate& Callback);
+
+		bool IsLoadingComplete() const { return !IsLoadingInProgress(); }
+		bool IsLoadingInProgress() const;
+		bool IsLoadingInProgressOrPending() const;
+		bool IsPendingDestroy() const;
+
+		/** Called by the scheduler once the state is no longer needed, releases it from its owner. */
+		/** 当状态不再需要时由调度器调用，将其从拥有者处释放。 */
+		void Reap();
+
+		/**
+		 * Intrusive node for the queues of the FAsyncMixinScheduler.  Queues are circular lists around a sentinel node,
+		 * unlinking only touches the neighbouring nodes, so an element can leave a queue while it's being processed.
+		 */
+		/**
+		 * FAsyncMixinScheduler 队列的侵入式节点。队列是围绕哨兵节点的循环链表，解除链接只会修改相邻节点，
+		 * 因此元素可以在队列被处理时离开队列。
+		 */
+		template <typename ElementType>
+		struct TQueueNode
+		{
+			TQueueNode* Prev = this;
+			TQueueNode* Next = this;
+
+			// Null on sentinels
+			ElementType* Element = nullptr;
+
+			bool IsLinked() const { return Next != this; }
+
+			void LinkBefore(TQueueNode& Sentinel)
+			{
+				Unlink();
+				Prev = Sentinel.Prev;
+				Next = &Sentinel;
+				Sentinel.Prev->Next = this;
+				Sentinel.Prev = this;
+			}
+
+			void Unlink()
+			{
+				Prev->Next = Next;
+				Next->Prev = Prev;
+				Prev = this;
+				Next = this;
+			}
+		};
+
+		using FQueueNode = TQueueNode<FLoadingState>;
+
+	private:
+		void CancelOnly(bool bDestroying);
+		void CancelStartTimer();
+		void TryScheduleStart();
+		void TryCompleteAsyncLoading();
+		void TryCompleteAsyncLoadingInOrder();
+		void TryCompleteAsyncLoadingOutOfOrder();
+		void CompleteAsyncLoading();
+
+		class FAsyncStep;
+
+		/** Stamps when a load step completed, then tries to advance the sequence. */
+		void HandleStepComplete(FAsyncStep* Step);
+
+		FAsyncStep& AddLoadStep(TArray<FSoftObjectPath>&& SoftObjectPaths, const FSimpleDelegate& DelegateToCall, TAsyncLoadPriority Priority,
+		                        const FAsyncLoadDeadline& Deadline, bool bCoalesce = true);
+
+		/** Destroys the coroutines suspended on the canceled steps from FirstStep on, see CancelOnly. */
+		void DestroySuspendedCoroutines(int32 FirstStep);
+
+		void ExecuteStep(FAsyncStep& Step);
+
+		/** Called by the scheduler when a step's deadline passes before its callback was called. */
+		void HandleMissedDeadline(FAsyncStep& Step);
+		void RetainCompletedStep(const FAsyncStep& Step) const;
+
+	private:
+		void RequestDestroyThisMemory();
+		void CancelDestroyThisMemory(bool bDestroying);
+
+		/** Who owns the loading state?  We need this to call back into the owning mix-in object.  Null while pooled. */
+		/** 谁拥有加载状态？我们需要这个来回调拥有的混合对象。在池中时为空。 */
+		FAsyncMixin* Owner = nullptr;
+
+		/**
+		 * Did we need to pre-load bundles?  If we didn't pre-load bundles (which require you keep the streaming handle 
+		 * around or they will be destroyed), then we can safely destroy the FLoadingState when everything is done loading.
+		 */
+		/**
+		 * 我们是否需要预加载包？如果我们没有预加载包（这需要你保持流处理句柄，
+		 * 否则它们将被销毁），那么当所有东西都加载完毕时，我们可以安全地销毁 FLoadingState。
+		 */
+		bool bPreloadedBundles = false;
+
+		class FAsyncStep
+		{
+		public:
+			FAsyncStep(const FSimpleDelegate& InUserCallback);
+			FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FStreamableHandle>& InStreamingHandle, TAsyncLoadPriority InPriority);
+			FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedRef<FAsyncMixinLoadBatch>& InBatch, TArray<FSoftObjectPath>&& InBatchPaths, TAsyncLoadPriority InPriority);
+			FAsyncStep(const FSimpleDelegate& InUserCallback, const TSharedPtr<FAsyncCondition>& InCondition);
+
+			~FAsyncStep();
+
+			void ExecuteUserCallback();
+
+			/** The step resumes this coroutine instead of calling a user callback, see AsyncMixinCoroutine.h. */
+			void SetCoroutine(void* InCoroutineAddress) { CoroutineAddress = InCoroutineAddress; }
+			void DestroySuspendedCoroutine();
+
+			bool IsLoadingInProgress() const
+			{
+				return !IsComplete();
+			}
+
+			bool IsComplete() const;
+			void Cancel();
+
+			/** Barriers keep their place in the sequence, even when the completion mode is out of order. */
+			bool IsBarrier() const { return bIsBarrier; }
+
+			bool HasExecutedUserCallback() const { return bHasExecutedUserCallback; }
+
+			TAsyncLoadPriority GetPriority() const { return Priority; }
+			void SetPriority(TAsyncLoadPriority NewPriority);
+
+			const TSharedPtr<FStreamableHandle>& GetStreamingHandle() const { return StreamingHandle; }
+			const TSharedPtr<FAsyncMixinLoadBatch>& GetBatch() const { return Batch; }
+			const TArray<FSoftObjectPath>& GetBatchPaths() const { return BatchPaths; }
+
+			/** Keeps the already resident objects of a preload alive, the streaming handle only holds the paths it loaded. */
+			void HoldResidentObjects(TArray<TStrongObjectPtr<UObject>>&& InResidentObjects) { ResidentObjects = MoveTemp(InResidentObjects); }
+
+			/** Is this step waiting on a load, rather than an event or a condition. */
+			bool IsLoad() const { return StreamingHandle.IsValid() || Batch.IsValid(); }
+
+			/** Timeline of the step, in FPlatformTime::Seconds. */
+			double GetEnqueueTime() const { return EnqueueTime; }
+			double GetIssueTime() const;
+			double GetCompleteTime() const { return CompleteTime; }
+			void MarkCompleteObserved(double Time);
+
+			bool BindCompleteDelegate(const FSimpleDelegate& NewDelegate);
+			bool IsCompleteDelegateBound() const;
+
+			/** Schedules OnMissed to be called on State if the callback hasn't been called Seconds after the step was requested. */
+			void SetDeadline(FLoadingState& State, const FAsyncLoadDeadline& Deadline);
+			void ClearDeadline();
+			bool HasMissedDeadline() const { return bMissedDeadline; }
+			void ExecuteMissedDeadlineCallback();
+
+		private:
+			void ReleaseBatch();
+
+			FSimpleDelegate UserCallback;
+
+			// std::coroutine_handle<> address, kept type-erased so this header doesn't need C++20.
+			void* CoroutineAddress = nullptr;
+
+			bool bIsCompletionDelegateBound = false;
+			bool bIsBarrier = false;
+			bool bHasExecutedUserCallback = false;
+			TAsyncLoadPriority Priority = 0;
+			double EnqueueTime = 0.0;
+			double CompleteTime = 0.0;
+
+			// Possible Async 'thing'
+			TSharedPtr<FStreamableHandle> StreamingHandle;
+			TSharedPtr<FAsyncMixinLoadBatch> Batch;
+			TArray<FSoftObjectPath> BatchPaths;
+			TSharedPtr<FAsyncCondition> Condition;
+			TArray<TStrongObjectPtr<UObject>> ResidentObjects;
+
+			// Linked into a slot of the scheduler's deadline wheel until the deadline passes or the callback is called.
+			FLoadingState* DeadlineState = nullptr;
+			FSimpleDelegate DeadlineCallback;
+			TQueueNode<FAsyncStep> DeadlineNode;
+			uint32 DeadlineRounds = 0;
+			bool bMissedDeadline = false;
+
+			friend class FAsyncMixinScheduler;
+		};
+
+		/**
+		 * Chunked storage for the steps of a state.  Slots are recycled, and the state itself is pooled, so a mix-in
+		 * that keeps canceling and requesting loads stops allocating steps once it has warmed up.
+		 */
+		class FAsyncStepPool
+		{
+		public:
+			FAsyncStepPool() = default;
+			~FAsyncStepPool();
+
+			FAsyncStepPool(const FAsyncStepPool&) = delete;
+			FAsyncStepPool& operator=(const FAsyncStepPool&) = delete;
+
+			template <typename... ArgTypes>
+			FAsyncStep* Allocate(ArgTypes&&... Args);
+
+			void Free(FAsyncStep* Step);
+
+		private:
+			static constexpr int32 StepsPerChunk = 8;
+
+			struct FChunk
+			{
+				TTypeCompatibleBytes<FAsyncStep> Slots[StepsPerChunk];
+			};
+
+			TArray<TUniquePtr<FChunk>> Chunks;
+			TArray<FAsyncStep*> FreeSlots;
+		};
+
+		template <typename... ArgTypes>
+		FAsyncStep& AddStep(ArgTypes&&... Args);
+
+		void FreePendingSteps();
+
+		bool bHasStarted = false;
+
+		int32 CurrentAsyncStep = 0;
+
+		// How many user callbacks we're currently inside of, steps can't be freed while one of them is executing.
+		int32 CallbackDepth = 0;
+
+		// When the first step of the current sequence was requested, and whether it has called back yet.
+		double SequenceStartTime = 0.0;
+		bool bHasCalledBack = false;
+
+		FAsyncStepPool StepPool;
+		TArray<FAsyncStep*> AsyncSteps;
+		TArray<FAsyncStep*> AsyncStepsPendingDestruction;
+
+		// Linked into the scheduler while waiting to be started next frame, or waiting to be released.
+		FQueueNode StartNode;
+		FQueueNode ReapNode;
+
+		friend class FAsyncMixinScheduler;
+	};
+
+	const FLoadingState& GetLoadingStateConst() const;
+
+	FLoadingState& GetLoadingState();
+
+	bool HasLoadingState() const;
+
+	bool IsLoadingInProgressOrPending() const;
+
+	/** Releases the loading state, returning it to the pool if nothing else is holding on to it. */
+	void ReleaseLoadingState();
+
+private:
+	TSharedPtr<FLoadingState> LoadingState;
+
+	/** Only allocated for mix-ins that take requests from other threads. */
+	TSharedPtr<FAsyncMixinRequestQueue, ESPMode::ThreadSafe> RequestQueue;
+
+	/** Loading states that have been released and can be handed to the next mix-in that needs one. */
+	static TArray<TSharedRef<FLoadingState>> LoadingStatePool;
+
+	friend class FAsyncMixinModule;
+	friend class FAsyncMixinScheduler;
+	friend FAsyncMixinRequestQueue;
+	friend FAsyncMixinLoadAwaiter;
+};
+
+/**
+ * Thread-safe submission of loads to a FAsyncMixin.  Worker threads can queue loads as soon as they know what they need,
+ * without marshalling back to the game thread first.  Requests are pushed onto a lock-free queue and handed to the
+ * mix-in by the scheduler on the game thread, which also starts the mix-in's async loading.  Callbacks are always
+ * called on the game thread.
+ *
+ * Requests reach the game thread on the next core ticker tick.  They've already waited a frame by then, so they skip the
+ * coalescer and are issued right away, only waiting for the admission controller's budget.
+ *
+ * Requests made after the mix-in is destroyed are dropped, and their callbacks destroyed on the game thread.
+ */
+/**
+ * 向 FAsyncMixin 线程安全地提交加载请求。工作线程可以在知道需要什么后立即排队加载，而无需先切换回游戏线程。
+ * 请求会被推入一个无锁队列，并由调度器在游戏线程上交给混合对象，同时启动混合对象的异步加载。回调总是在游戏线程上调用。
+ *
+ * 请求会在下一次核心 Ticker tick 时到达游戏线程。此时它们已经等待了一帧，因此会跳过合并器并立即发出，只需等待准入控制器的预算。
+ *
+ * 混合对象销毁后发出的请求会被丢弃，其回调会在游戏线程上销毁。
+ */
+class ASYNCMIXIN_API FAsyncMixinRequestQueue : public TSharedFromThis<FAsyncMixinRequestQueue, ESPMode::ThreadSafe>
+{
+public:
+	/** Async load a FSoftObjectPath from any thread, call the Callback on the game thread when complete. */
+	/** 从任意线程异步加载 FSoftObjectPath，完成时在游戏线程上调用 Callback。 */
+	void AsyncLoad(const FSoftObjectPath& SoftObjectPath, TFunction<void()>&& Callback = TFunction<void()>(),
+	               TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Async load an array of FSoftObjectPath from any thread, call the Callback on the game thread when complete. */
+	/** 从任意线程异步加载 FSoftObjectPath 数组，完成时在游戏线程上调用 Callback。 */
+	void AsyncLoad(TArray<FSoftObjectPath> SoftObjectPaths, TFunction<void()>&& Callback = TFunction<void()>(),
+	               TAsyncLoadPriority Priority = FStreamableManager::AsyncLoadHighPriority);
+
+	/** Preload the bundles of primary assets from any thread, call the Callback on the game thread when complete. */
+	/** 从任意线程预加载主资产的捆绑包，完成时在游戏线程上调用 Callback。 */
+	void AsyncPreloadPrimaryAssetsAndBundles(TArray<FPrimaryAssetId> AssetIds, TArray<FName> LoadBundles, TFunction<void()>&& Callback = TFunction<void()>(),
+	                                         TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+private:
+	friend FAsyncMixin;
+	friend class FAsyncMixinScheduler;
+
+	struct FRequest
+	{
+		TArray<FSoftObjectPath> SoftObjectPaths;
+		TArray<FPrimaryAssetId> AssetIds;
+		TArray<FName> LoadBundles;
+		TFunction<void()> Callback;
+		TAsyncLoadPriority Priority = 0;
+		bool bPreload = false;
+	};
+
+	explicit FAsyncMixinRequestQueue(FAsyncMixin& InOwner);
+
+	void Enqueue(FRequest&& Request);
+
+	/** Hands every queued request to the owner, game thread only */
+	void Drain();
+
+	/** Called by the owner when it's destroyed, game thread only */
+	void DetachFromOwner();
+
+	// Only touched on the game thread
+	FAsyncMixin* Owner = nullptr;
+
+	TQueue<FRequest, EQueueMode::Mpsc> Requests;
+
+	// Set while the queue is on the scheduler's list of queues to drain
+	std::atomic<bool> bQueuedForDrain = false;
+};
+
+/**
+ * Sometimes a mix-in just doesn't make sense.  Perhaps the object has to manage many different jobs
+ * that each have their own async dependency chain/scope.  For those situations you can use the FAsyncScope.
+ * 
+ * This class is a standalone Async dependency handler so that you can fire off several load jobs and always handle them
+ * in the proper order, just like with combining FAsyncMixin with your class.
+ */
+/**
+ * 有时候，混入（mix-in）可能并不合适。也许对象必须管理许多不同的工作，
+ * 每个工作都有自己的异步依赖链/范围。对于这些情况，您可以使用 FAsyncScope。
+ * 
+ * 这个类是一个独立的异步依赖处理器，所以你可以发起几个加载任务，并始终以正确的顺序处理它们，
+ * 就像将 FAsyncMixin 与你的类结合使用一样。
+ */
+class ASYNCMIXIN_API FAsyncScope : public FAsyncMixin
+{
+public:
+	using FAsyncMixin::AsyncLoad;
+
+	using FAsyncMixin::AsyncLoadAwait;
+
+	using FAsyncMixin::AsyncLoadAndPrewarm;
+
+	using FAsyncMixin::AsyncPreloadPrimaryAssetsAndBundles;
+
+	using FAsyncMixin::AsyncCondition;
+
+	using FAsyncMixin::AsyncEvent;
+
+	using FAsyncMixin::CancelAsyncLoading;
+
+	using FAsyncMixin::StartAsyncLoading;
+
+	using FAsyncMixin::IsAsyncLoadingInProgress;
+
+	using FAsyncMixin::SetAsyncLoadingPriority;
+
+	/** Change how callbacks are ordered, see EAsyncMixinCompletionMode. */
+	/** 更改回调的顺序方式，参见 EAsyncMixinCompletionMode。 */
+	void SetAsyncLoadingCompletionMode(EAsyncMixinCompletionMode InCompletionMode)
+	{
+		CompletionMode = InCompletionMode;
+	}
+
+	/** Change what happens to completed loads, see EAsyncMixinRetentionPolicy. */
+	/** 更改已完成加载的处理方式，参见 EAsyncMixinRetentionPolicy。 */
+	void SetAsyncLoadingRetentionPolicy(EAsyncMixinRetentionPolicy InRetentionPolicy)
+	{
+		RetentionPolicy = InRetentionPolicy;
+	}
+
+	/** Change the key loads are recorded and prefetched under, see GetAsyncLoadingAccessKey. */
+	/** 更改记录和预取加载所使用的键，参见 GetAsyncLoadingAccessKey。 */
+	void SetAsyncLoadingAccessKey(FName InAccessKey)
+	{
+		AccessKey = InAccessKey;
+	}
+
+protected:
+	virtual EAsyncMixinCompletionMode GetAsyncLoadingCompletionMode() const override
+	{
+		return CompletionMode;
+	}
+
+	virtual EAsyncMixinRetentionPolicy GetAsyncLoadingRetentionPolicy() const override
+	{
+		return RetentionPolicy;
+	}
+
+	virtual FName GetAsyncLoadingAccessKey() const override
+	{
+		return AccessKey;
+	}
+
+private:
+	EAsyncMixinCompletionMode CompletionMode = EAsyncMixinCompletionMode::InOrder;
+	EAsyncMixinRetentionPolicy RetentionPolicy = EAsyncMixinRetentionPolicy::Default;
+	FName AccessKey;
+};
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+enum class EAsyncConditionResult : uint8
+{
+	TryAgain, // 条件不满足
+	Complete // 条件满足
+};
+
+DECLARE_DELEGATE_RetVal(EAsyncConditionResult, FAsyncConditionDelegate);
+
+/**
+ * How often a bound FAsyncCondition re-evaluates its condition while it waits.
+ */
+/**
+ * 已绑定的 FAsyncCondition 在等待期间重新评估其条件的频率。
+ */
+struct FAsyncConditionPollingPolicy
+{
+	/** Seconds between binding the condition and the first poll. */
+	/** 从绑定条件到第一次轮询之间的秒数。 */
+	float InitialInterval = 0.16f;
+
+	/** Every time the condition still isn't met the interval is multiplied by this, 1 polls at a fixed interval. */
+	/** 每次条件仍未满足时，间隔都会乘以该值，为 1 时以固定间隔轮询。 */
+	float BackoffMultiplier = 1.0f;
+
+	/** Upper bound of the interval. */
+	/** 间隔的上限。 */
+	float MaxInterval = 0.16f;
+
+	/** If false the condition is never polled, it's only evaluated when it's signalled. */
+	/** 如果为 false，则永远不会轮询该条件，只有在收到信号时才会评估。 */
+	bool bPoll = true;
+
+	static FAsyncConditionPollingPolicy FixedInterval(float Interval)
+	{
+		FAsyncConditionPollingPolicy Policy;
+		Policy.InitialInterval = Interval;
+		Policy.MaxInterval = Interval;
+		return Policy;
+	}
+
+	static FAsyncConditionPollingPolicy ExponentialBackoff(float InitialInterval, float MaxInterval, float Multiplier = 2.0f)
+	{
+		FAsyncConditionPollingPolicy Policy;
+		Policy.InitialInterval = InitialInterval;
+		Policy.MaxInterval = FMath::Max(InitialInterval, MaxInterval);
+		Policy.BackoffMultiplier = FMath::Max(1.0f, Multiplier);
+		return Policy;
+	}
+
+	static FAsyncConditionPollingPolicy SignalOnly()
+	{
+		FAsyncConditionPollingPolicy Policy;
+		Policy.bPoll = false;
+		return Policy;
+	}
+};
+
+/**
+ * The async condition allows you to have custom reasons to hault the async loading until some condition is met.
+ *
+ * By default a bound condition polls its delegate on a fixed interval.  Conditions that know when they might have
+ * become true should call Signal() (or be hooked up to a multicast delegate with SignalOn()) and use the SignalOnly
+ * policy, so waiting costs nothing.  Conditions that have to poll can use ExponentialBackoff to poll less as time goes on.
+ * A default constructed condition has nothing to evaluate, and completes the first time it's signalled.
+ */
+/**
+ * 异步条件允许你有自定义的原因来暂停异步加载，直到满足某些条件。
+ *
+ * 默认情况下，已绑定的条件会以固定间隔轮询其委托。知道自己何时可能变为真的条件应该调用 Signal()
+ * （或者通过 SignalOn() 挂接到多播委托上）并使用 SignalOnly 策略，这样等待就没有任何开销。
+ * 必须轮询的条件可以使用 ExponentialBackoff，随着时间推移减少轮询次数。
+ * 默认构造的条件没有需要评估的内容，会在第一次收到信号时完成。
+ */
+class ASYNCMIXIN_API FAsyncCondition : public TSharedFromThis<FAsyncCondition>
+{
+public:
+	FAsyncCondition();
+	FAsyncCondition(const FAsyncConditionDelegate& Condition, const FAsyncConditionPollingPolicy& InPollingPolicy = FAsyncConditionPollingPolicy());
+	FAsyncCondition(TFunction<EAsyncConditionResult()>&& Condition, const FAsyncConditionPollingPolicy& InPollingPolicy = FAsyncConditionPollingPolicy());
+	virtual ~FAsyncCondition();
+
+	/**
+	 * Lets the condition know it may have been met.  The condition is evaluated immediately, or if there's nothing to
+	 * evaluate it's completed.  Must be called on the game thread.
+	 */
+	/**
+	 * 通知条件它可能已经满足。条件会被立即评估，如果没有需要评估的内容，则直接完成。必须在游戏线程上调用。
+	 */
+	void Signal();
+
+	/**
+	 * Signals the condition every time the multicast delegate is broadcast.  The binding is weak, so it's fine for
+	 * the delegate to outlive the condition.
+	 */
+	/**
+	 * 每次广播多播委托时向条件发送信号。绑定是弱引用的，因此委托的生命周期比条件长也没有问题。
+	 */
+	template <typename... ParamTypes, typename UserPolicy>
+	FDelegateHandle SignalOn(TMulticastDelegate<void(ParamTypes...), UserPolicy>& MulticastDelegate)
+	{
+		return MulticastDelegate.AddSPLambda(this, [this](ParamTypes...) { Signal(); });
+	}
+
+protected:
+	bool IsComplete() const;
+	bool BindCompleteDelegate(const FSimpleDelegate& NewDelegate);
+
+private:
+	bool TryToContinue(float DeltaTime);
+	void SchedulePoll(float Interval);
+	void CompleteCondition();
+
+	FTSTicker::FDelegateHandle RepeatHandle;
+	FAsyncConditionDelegate UserCondition;
+	FSimpleDelegate CompletionDelegate;
+
+	FAsyncConditionPollingPolicy PollingPolicy;
+	float CurrentPollInterval = 0.0f;
+
+	// Set for conditions without a delegate, they're only complete once they've been signalled.
+	bool bWaitForSignal = false;
+	bool bCompleted = false;
+
+	friend FAsyncMixin;
+};
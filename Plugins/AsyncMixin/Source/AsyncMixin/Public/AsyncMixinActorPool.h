@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+
+#include "AsyncMixinActorPool.generated.h"
+
+class AActor;
+class APawn;
+
+USTRUCT()
+struct FAsyncMixinPooledActors
+{
+	GENERATED_BODY()
+
+	// Spawned and parked out of the way, waiting to be handed out, the newest is at the end and handed out first
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> Actors;
+
+	// How many instances prewarming keeps around
+	int32 TargetCount = 0;
+};
+
+/**
+ * Pre-spawns actors of classes that just finished loading, so that spawning the first ones doesn't hitch on creating
+ * their components, running their construction scripts and BeginPlay.  Pooled actors are fully spawned a few per frame
+ * within AsyncMixin.ActorPool.PrewarmBudgetMs, then parked far above the origin, hidden, without collision and with
+ * their actor tick disabled.  SpawnActor() hands one of them out: it moves it to the requested transform, applies the
+ * collision handling method, sets its owner and instigator, and restores hidden, collision and tick from the class
+ * defaults.  It spawns a new actor if the pool is empty.
+ *
+ * Pooled actors have already begun play by the time they are handed out, state that depends on the spawn transform or
+ * the owner has to be set up again by the caller.
+ *
+ * Mix-ins fill the pool with AsyncLoadAndPrewarm, which only calls back once the class is loaded and the pool is warm.
+ *
+ * Game and PIE worlds only.
+ */
+/**
+ * 预先生成刚完成加载的类的 Actor，这样生成前几个 Actor 时不会因为创建组件、运行构造脚本和 BeginPlay 而卡顿。
+ * 池中的 Actor 每帧在 AsyncMixin.ActorPool.PrewarmBudgetMs 预算内完整生成几个，然后停放在原点上方远处，
+ * 隐藏、没有碰撞并禁用 Actor 的 Tick。SpawnActor() 会取出其中一个：将它移动到请求的变换处，应用碰撞处理方式，
+ * 设置其所有者和发起者，并根据类默认对象恢复隐藏、碰撞和 Tick 状态。如果池为空则生成一个新的 Actor。
+ *
+ * 池中的 Actor 在取出时已经开始游戏，依赖生成变换或所有者的状态需要由调用者重新设置。
+ *
+ * 混合对象通过 AsyncLoadAndPrewarm 填充池，它只会在类加载完成且池已预热后才回调。
+ *
+ * 仅用于游戏和 PIE 世界。
+ */
+UCLASS()
+class ASYNCMIXIN_API UAsyncMixinActorPool : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UAsyncMixinActorPool* Get(const UWorld* World);
+
+	/** Keeps at least Count spawned instances of the class in the pool, the missing ones are built over the next frames. */
+	/** 在池中保留至少 Count 个已生成的该类实例，缺少的实例会在接下来的几帧中生成。 */
+	void Prewarm(TSubclassOf<AActor> ActorClass, int32 Count);
+
+	/** Whether instances of the class are still being spawned. */
+	/** 该类的实例是否仍在生成中。 */
+	bool IsPrewarming(TSubclassOf<AActor> ActorClass) const;
+
+	int32 GetNumPooled(TSubclassOf<AActor> ActorClass) const;
+
+	/**
+	 * Spawns an actor of the class, or hands out a pooled one if there's one ready.  Returns null if the collision
+	 * handling method doesn't allow it at the transform, the pooled actor then stays in the pool.
+	 */
+	/**
+	 * 生成该类的 Actor，如果池中有就绪的实例则取出一个。如果碰撞处理方式不允许在该变换处生成则返回空，
+	 * 此时池中的 Actor 会留在池中。
+	 */
+	AActor* SpawnActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr,
+	                   ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::Undefined);
+
+	template <typename T>
+	T* SpawnActor(TSubclassOf<T> ActorClass, const FTransform& Transform, AActor* Owner = nullptr, APawn* Instigator = nullptr,
+	              ESpawnActorCollisionHandlingMethod CollisionHandling = ESpawnActorCollisionHandlingMethod::Undefined)
+	{
+		return Cast<T>(SpawnActor(TSubclassOf<AActor>(ActorClass.Get()), Transform, Owner, Instigator, CollisionHandling));
+	}
+
+	/** Destroys the pooled instances of the class and stops prewarming it. */
+	/** 销毁该类在池中的实例并停止预热。 */
+	void Drain(TSubclassOf<AActor> ActorClass);
+
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableGameObject interface
+
+protected:
+	//~UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End of UWorldSubsystem interface
+
+private:
+	AActor* ConstructPooledActor(TSubclassOf<AActor> ActorClass);
+
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<AActor>, FAsyncMixinPooledActors> Pools;
+};
@@ -0,0 +1,136 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "AsyncMixin.h"
+
+#include <coroutine>
+
+/**
+ * Coroutine front-end for the FAsyncMixin.  Instead of chaining callbacks, a mix-in can write its loading sequence as a
+ * coroutine that returns FAsyncMixinTask and awaits each load,
+ *
+ * FAsyncMixinTask UMyWidget::ShowItem(TSoftObjectPtr<UMyItemData> ItemPtr)
+ * {
+ *     UMyItemData* Item = co_await AsyncLoadAwait(ItemPtr);
+ *     UTexture2D* Icon = co_await AsyncLoadAwait(Item->Icon);
+ *     IconImage->SetBrushFromTexture(Icon);
+ * }
+ *
+ * Each await adds a step to the same loading state the callback API uses, so ordering, priorities, coalescing,
+ * retention and OnStartedLoading/OnFinishedLoading all behave the same.  A step resumes the coroutine directly instead of
+ * calling a delegate, so awaiting doesn't allocate a delegate or a TFunction, and frames come from a pool.
+ *
+ * CancelAsyncLoading, or destroying the mix-in, destroys the frames of coroutines suspended on its loads, so capturing
+ * [this] stays as safe as it is with callbacks.  The destructors of the coroutine's locals run at that point, they
+ * mustn't call back into the mix-in.  Coroutines are started, resumed and destroyed on the game thread only.
+ *
+ * Modules including this header must compile as C++20.
+ */
+/**
+ * FAsyncMixin 的协程前端。混合对象可以将其加载序列编写为返回 FAsyncMixinTask 的协程，并等待每个加载，而不是串联回调：
+ *
+ * FAsyncMixinTask UMyWidget::ShowItem(TSoftObjectPtr<UMyItemData> ItemPtr)
+ * {
+ *     UMyItemData* Item = co_await AsyncLoadAwait(ItemPtr);
+ *     UTexture2D* Icon = co_await AsyncLoadAwait(Item->Icon);
+ *     IconImage->SetBrushFromTexture(Icon);
+ * }
+ *
+ * 每次等待都会向回调 API 使用的同一个加载状态添加一个步骤，因此顺序、优先级、请求合并、保留以及
+ * OnStartedLoading/OnFinishedLoading 的行为都相同。步骤会直接恢复协程而不是调用委托，因此等待不会分配委托或 TFunction，
+ * 协程帧也来自一个池。
+ *
+ * CancelAsyncLoading 或销毁混合对象时，会销毁挂起在其加载上的协程帧，因此捕获 [this] 与使用回调时一样安全。
+ * 此时会运行协程局部变量的析构函数，它们不能回调混合对象。协程只在游戏线程上启动、恢复和销毁。
+ *
+ * 包含此头文件的模块必须以 C++20 编译。
+ */
+class FAsyncMixinTask
+{
+public:
+	struct promise_type
+	{
+		FAsyncMixinTask get_return_object() { return FAsyncMixinTask(); }
+
+		// Runs eagerly up to the first await, and frees its frame as soon as it finishes.
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+
+		void return_void() {}
+		void unhandled_exception() { checkNoEntry(); }
+
+		static void* operator new(SIZE_T Size);
+		static void operator delete(void* Memory, SIZE_T Size);
+	};
+};
+
+/**
+ * Awaiter returned by FAsyncMixin::AsyncLoadAwait.  If nothing is loading and everything is already in memory the
+ * coroutine carries on without suspending, otherwise it's resumed when its step is reached in the sequence.
+ */
+/**
+ * FAsyncMixin::AsyncLoadAwait 返回的等待对象。如果没有正在进行的加载并且所有内容都已在内存中，协程会继续执行而不挂起，
+ * 否则会在序列执行到其步骤时恢复。
+ */
+class ASYNCMIXIN_API FAsyncMixinLoadAwaiter
+{
+public:
+	FAsyncMixinLoadAwaiter(FAsyncMixin& InMixin, TArray<FSoftObjectPath>&& InSoftObjectPaths, TAsyncLoadPriority InPriority);
+
+	FAsyncMixinLoadAwaiter(const FAsyncMixinLoadAwaiter&) = delete;
+	FAsyncMixinLoadAwaiter& operator=(const FAsyncMixinLoadAwaiter&) = delete;
+
+	bool await_ready() const;
+	void await_suspend(std::coroutine_handle<> Handle);
+	void await_resume() const {}
+
+private:
+	FAsyncMixin& Mixin;
+	TArray<FSoftObjectPath> SoftObjectPaths;
+	TAsyncLoadPriority Priority;
+};
+
+template <typename T>
+class TAsyncMixinObjectAwaiter : public FAsyncMixinLoadAwaiter
+{
+public:
+	TAsyncMixinObjectAwaiter(FAsyncMixin& InMixin, TSoftObjectPtr<T> InSoftObject, TAsyncLoadPriority InPriority)
+		: FAsyncMixinLoadAwaiter(InMixin, TArray<FSoftObjectPath>{ InSoftObject.ToSoftObjectPath() }, InPriority)
+		, SoftObject(MoveTemp(InSoftObject))
+	{
+	}
+
+	T* await_resume() const { return SoftObject.Get(); }
+
+private:
+	TSoftObjectPtr<T> SoftObject;
+};
+
+template <typename T>
+class TAsyncMixinClassAwaiter : public FAsyncMixinLoadAwaiter
+{
+public:
+	TAsyncMixinClassAwaiter(FAsyncMixin& InMixin, TSoftClassPtr<T> InSoftClass, TAsyncLoadPriority InPriority)
+		: FAsyncMixinLoadAwaiter(InMixin, TArray<FSoftObjectPath>{ InSoftClass.ToSoftObjectPath() }, InPriority)
+		, SoftClass(MoveTemp(InSoftClass))
+	{
+	}
+
+	TSubclassOf<T> await_resume() const { return SoftClass.Get(); }
+
+private:
+	TSoftClassPtr<T> SoftClass;
+};
+
+template <typename T>
+TAsyncMixinObjectAwaiter<T> FAsyncMixin::AsyncLoadAwait(TSoftObjectPtr<T> SoftObject, TAsyncLoadPriority Priority)
+{
+	return TAsyncMixinObjectAwaiter<T>(*this, MoveTemp(SoftObject), Priority);
+}
+
+template <typename T>
+TAsyncMixinClassAwaiter<T> FAsyncMixin::AsyncLoadAwait(TSoftClassPtr<T> SoftClass, TAsyncLoadPriority Priority)
+{
+	return TAsyncMixinClassAwaiter<T>(*this, MoveTemp(SoftClass), Priority);
+}
@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/SoftObjectPath.h"
+
+class FArchive;
+
+/**
+ * Flat dependency closures of the assets mix-ins load, precomputed by the AsyncMixinDependencyManifest commandlet.
+ *
+ * Without it, the first request for an asset only finds out about its dependencies as each package is loaded and
+ * read, and their loads are issued one level at a time.  With it, every batch is issued together with the dependency
+ * closure of its paths, so the whole tree is requested up front in a single streamable request.
+ *
+ * The manifest is written to Content/AsyncMixin/DependencyManifest.bin, which is staged as a non-asset file, and
+ * loaded when the module starts up.  Set AsyncMixin.DependencyManifest.Enable 0 to ignore it.
+ */
+/**
+ * 混合对象加载的资源的扁平依赖闭包，由 AsyncMixinDependencyManifest 命令行工具预先计算。
+ *
+ * 如果没有它，对资源的第一次请求只能在加载并读取每个包时才发现其依赖项，依赖项的加载会一层一层地发出。
+ * 有了它，每个批次都会与其路径的依赖闭包一起发出，因此整棵依赖树会在一个流式请求中预先请求。
+ *
+ * 清单写入 Content/AsyncMixin/DependencyManifest.bin，作为非资源文件进行暂存，并在模块启动时加载。
+ * 设置 AsyncMixin.DependencyManifest.Enable 0 可以忽略它。
+ */
+class ASYNCMIXIN_API FAsyncMixinDependencyManifest
+{
+public:
+	static FAsyncMixinDependencyManifest& Get();
+
+	/** Where the commandlet writes the manifest and the module reads it from. */
+	/** 命令行工具写入清单以及模块读取清单的位置。 */
+	static FString GetDefaultPath();
+
+	/**
+	 * Records the dependency closure of a package.  Each package is identified by the path of its main asset, which is
+	 * what gets requested to load it.
+	 */
+	/**
+	 * 记录一个包的依赖闭包。每个包由其主资源的路径标识，加载它时请求的就是该路径。
+	 */
+	void AddClosure(const FSoftObjectPath& Root, const TArray<FSoftObjectPath>& Dependencies);
+
+	/** Appends the dependencies of the paths that aren't loaded and aren't in the array yet. */
+	/** 追加这些路径中尚未加载且尚未在数组中的依赖项。 */
+	void AppendClosure(TArray<FSoftObjectPath>& SoftObjectPaths) const;
+
+	bool LoadFromFile(const FString& Filename);
+	bool SaveToFile(const FString& Filename);
+
+	int32 NumClosures() const { return Closures.Num(); }
+
+	void Reset();
+
+private:
+	static constexpr uint32 FileMagic = 0x4D444D41; // 'AMDM'
+	static constexpr uint32 FileVersion = 1;
+
+	int32 FindOrAddPackage(const FSoftObjectPath& SoftObjectPath);
+	void Serialize(FArchive& Ar);
+
+	// The main asset of every package in the manifest, closures refer to them by index
+	TArray<FSoftObjectPath> Packages;
+	TMap<FName, int32> PackageIndices;
+
+	// Package index of a root, to the package indices of its dependencies
+	TMap<int32, TArray<int32>> Closures;
+};
@@ -0,0 +1,173 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "AsyncMixinDependencyManifestCommandlet.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AsyncMixinDependencyManifest.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AsyncMixinDependencyManifestCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncMixinDependencyManifestCommandlet, Log, All);
+
+namespace AsyncMixinDependencyManifest
+{
+	static bool IsLoadablePackage(FName PackageName)
+	{
+		// Script packages are always loaded, and there's nothing to request for them.
+		return !FPackageName::IsScriptPackage(PackageName.ToString());
+	}
+
+	static bool GetMainAssetPath(const IAssetRegistry& AssetRegistry, FName PackageName, FSoftObjectPath& OutSoftObjectPath)
+	{
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByPackageName(PackageName, Assets, /*bIncludeOnlyOnDiskAssets*/true);
+
+		for (const FAssetData& Asset : Assets)
+		{
+			if (Asset.IsUAsset())
+			{
+				OutSoftObjectPath = Asset.GetSoftObjectPath();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	static void GetHardClosure(const IAssetRegistry& AssetRegistry, FName Root, TArray<FName>& OutClosure)
+	{
+		TSet<FName> Visited;
+		Visited.Add(Root);
+
+		TArray<FName> Stack;
+		Stack.Add(Root);
+
+		const UE::AssetRegistry::FDependencyQuery HardQuery(UE::AssetRegistry::EDependencyQuery::Hard);
+
+		while (Stack.Num() > 0)
+		{
+			const FName PackageName = Stack.Pop(/*bAllowShrinking*/false);
+
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, HardQuery);
+
+			for (const FName Dependency : Dependencies)
+			{
+				bool bAlreadyVisited = false;
+				Visited.Add(Dependency, &bAlreadyVisited);
+
+				if (!bAlreadyVisited && IsLoadablePackage(Dependency))
+				{
+					OutClosure.Add(Dependency);
+					Stack.Add(Dependency);
+				}
+			}
+		}
+	}
+}
+
+UAsyncMixinDependencyManifestCommandlet::UAsyncMixinDependencyManifestCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UAsyncMixinDependencyManifestCommandlet::Main(const FString& Params)
+{
+	using namespace AsyncMixinDependencyManifest;
+
+	FString RootsParam = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Roots="), RootsParam);
+
+	FString OutputPath = FAsyncMixinDependencyManifest::GetDefaultPath();
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	TArray<FString> Roots;
+	RootsParam.ParseIntoArray(Roots, TEXT("+"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(/*bSynchronousSearch*/true);
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& Root : Roots)
+	{
+		Filter.PackagePaths.Add(FName(*Root));
+	}
+
+	TArray<FAssetData> Assets;
+	AssetRegistry.GetAssets(Filter, Assets);
+
+	// The soft references of the assets under the roots are what mix-ins get asked to load.
+	TSet<FName> SoftReferenced;
+	{
+		TSet<FName> Referencers;
+		for (const FAssetData& Asset : Assets)
+		{
+			Referencers.Add(Asset.PackageName);
+		}
+
+		const UE::AssetRegistry::FDependencyQuery SoftQuery(UE::AssetRegistry::EDependencyQuery::Soft);
+		for (const FName Referencer : Referencers)
+		{
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(Referencer, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, SoftQuery);
+
+			for (const FName Dependency : Dependencies)
+			{
+				if (IsLoadablePackage(Dependency))
+				{
+					SoftReferenced.Add(Dependency);
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogAsyncMixinDependencyManifestCommandlet, Display, TEXT("Found %d soft referenced packages under %s"), SoftReferenced.Num(), *RootsParam);
+
+	FAsyncMixinDependencyManifest Manifest;
+
+	for (const FName Root : SoftReferenced)
+	{
+		FSoftObjectPath RootPath;
+		if (!GetMainAssetPath(AssetRegistry, Root, RootPath))
+		{
+			continue;
+		}
+
+		TArray<FName> Closure;
+		GetHardClosure(AssetRegistry, Root, Closure);
+
+		// Roots without hard dependencies have nothing to request up front.
+		if (Closure.Num() == 0)
+		{
+			continue;
+		}
+
+		TArray<FSoftObjectPath> Dependencies;
+		Dependencies.Reserve(Closure.Num());
+
+		for (const FName Dependency : Closure)
+		{
+			FSoftObjectPath DependencyPath;
+			if (GetMainAssetPath(AssetRegistry, Dependency, DependencyPath))
+			{
+				Dependencies.Add(DependencyPath);
+			}
+		}
+
+		Manifest.AddClosure(RootPath, Dependencies);
+	}
+
+	if (!Manifest.SaveToFile(OutputPath))
+	{
+		UE_LOG(LogAsyncMixinDependencyManifestCommandlet, Error, TEXT("Failed to write the dependency manifest to '%s'"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogAsyncMixinDependencyManifestCommandlet, Display, TEXT("Wrote %d dependency closures to '%s'"), Manifest.NumClosures(), *OutputPath);
+	return 0;
+}
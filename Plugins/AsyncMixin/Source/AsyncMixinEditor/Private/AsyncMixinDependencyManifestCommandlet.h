@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "AsyncMixinDependencyManifestCommandlet.generated.h"
+
+/**
+ * Writes the dependency manifest mix-ins request the closure of their loads from (see FAsyncMixinDependencyManifest).
+ *
+ * Every package soft referenced by an asset under the roots is something a mix-in may load, its closure is every
+ * package it hard references, recursively.  Run it before cooking so the manifest matches the cooked content:
+ *
+ *   UnrealEditor-Cmd UnrealPractice.uproject -run=AsyncMixinDependencyManifest [-Roots=/Game+/Plugin] [-Output=Path]
+ */
+UCLASS()
+class UAsyncMixinDependencyManifestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAsyncMixinDependencyManifestCommandlet();
+
+	//~UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	//~End of UCommandlet interface
+};
@@ -1,24 +0,0 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "Modules/ModuleManager.h"
-
-class FAsyncMixinModule : public IModuleInterface
-{
-public:
-	/** IModuleInterface implementation */
-	virtual void StartupModule() override;
-	virtual void ShutdownModule() override;
-};
-
-void FAsyncMixinModule::StartupModule()
-{
-	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-}
-
-void FAsyncMixinModule::ShutdownModule()
-{
-	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
-	// we call this function before unloading the module.
-}
-	
-IMPLEMENT_MODULE(FAsyncMixinModule, AsyncMixin)
@@ -8,6 +8,9 @@ public class GameplayMessageRuntime : ModuleRules
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;				
 
+		// NextMessage() is a C++20 coroutine awaitable
+		CppStandard = CppStandardVersion.Cpp20;
+
 		PublicDependencyModuleNames.AddRange(
 			new string[]
 			{
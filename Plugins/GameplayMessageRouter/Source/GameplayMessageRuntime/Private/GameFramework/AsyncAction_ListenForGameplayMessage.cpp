@@ -37,16 +37,19 @@ void UAsyncAction_ListenForGameplayMessage::Activate()
 			UGameplayMessageSubsystem& Router = UGameplayMessageSubsystem::Get(World);
 
 			TWeakObjectPtr<UAsyncAction_ListenForGameplayMessage> WeakThis(this);
-			ListenerHandle = Router.RegisterListenerInternal(ChannelToRegister,
-				[WeakThis](FGameplayTag Channel, const UScriptStruct* StructType, const void* Payload)
+			auto Callback = [WeakThis](FGameplayTag Channel, const UScriptStruct* StructType, const void* Payload)
+			{
+				if (UAsyncAction_ListenForGameplayMessage* StrongThis = WeakThis.Get())
 				{
-					if (UAsyncAction_ListenForGameplayMessage* StrongThis = WeakThis.Get())
-					{
-						StrongThis->HandleMessageReceived(Channel, StructType, Payload);
-					}
-				},
+					StrongThis->HandleMessageReceived(Channel, StructType, Payload);
+				}
+			};
+
+			ListenerHandle = Router.RegisterListenerInternal(ChannelToRegister,
+				Callback,
 				MessageStructType.Get(),
-				MessageMatchType);
+				MessageMatchType,
+				UGameplayMessageSubsystem::GetCallbackCaptureSize<decltype(Callback), decltype(Callback)>());
 
 			return;
 		}
@@ -0,0 +1,181 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GameplayMessagePayloadArena.h"
+
+#include "HAL/IConsoleManager.h"
+
+namespace UE
+{
+	namespace GameplayMessageSubsystem
+	{
+		static int32 MaxPooledPayloadBlocks = 64;
+		static FAutoConsoleVariableRef CVarMaxPooledPayloadBlocks(TEXT("GameplayMessageSubsystem.PayloadArena.MaxPooledBlocks"),
+			MaxPooledPayloadBlocks,
+			TEXT("Maximum number of free payload blocks kept per size class by each gameplay message subsystem."));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// FGameplayMessagePayloadRef
+
+FGameplayMessagePayloadRef::FGameplayMessagePayloadRef(const FGameplayMessagePayloadRef& Other)
+	: Block(Other.Block)
+{
+	if (Block)
+	{
+		Block->RefCount.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+FGameplayMessagePayloadRef::FGameplayMessagePayloadRef(FGameplayMessagePayloadRef&& Other)
+	: Block(Other.Block)
+{
+	Other.Block = nullptr;
+}
+
+FGameplayMessagePayloadRef& FGameplayMessagePayloadRef::operator=(const FGameplayMessagePayloadRef& Other)
+{
+	if (Block != Other.Block)
+	{
+		FGameplayMessagePayloadRef Copy(Other);
+		Swap(Block, Copy.Block);
+	}
+	return *this;
+}
+
+FGameplayMessagePayloadRef& FGameplayMessagePayloadRef::operator=(FGameplayMessagePayloadRef&& Other)
+{
+	if (this != &Other)
+	{
+		Reset();
+		Block = Other.Block;
+		Other.Block = nullptr;
+	}
+	return *this;
+}
+
+FGameplayMessagePayloadRef::~FGameplayMessagePayloadRef()
+{
+	Reset();
+}
+
+const UScriptStruct* FGameplayMessagePayloadRef::GetStructType() const
+{
+	return Block ? Block->StructType : nullptr;
+}
+
+const void* FGameplayMessagePayloadRef::GetPayload() const
+{
+	return Block ? Block->GetPayload() : nullptr;
+}
+
+void FGameplayMessagePayloadRef::Reset()
+{
+	if (FGameplayMessagePayloadBlock* OldBlock = Block)
+	{
+		Block = nullptr;
+
+		if (OldBlock->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			// Hold the arena locally, the block gives up its reference when it's pooled and this may be the last one
+			TSharedPtr<FGameplayMessagePayloadArena, ESPMode::ThreadSafe> Arena = MoveTemp(OldBlock->Arena);
+			Arena->Free(OldBlock);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// FGameplayMessagePayloadArena
+
+FGameplayMessagePayloadArena::~FGameplayMessagePayloadArena()
+{
+	for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+	{
+		while (FGameplayMessagePayloadBlock* Block = FreeBlocks[SizeClass].Pop())
+		{
+			FMemory::Free(Block);
+		}
+	}
+}
+
+int32 FGameplayMessagePayloadArena::GetSizeClass(SIZE_T Size)
+{
+	for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+	{
+		if (Size <= GetSizeClassBytes(SizeClass))
+		{
+			return SizeClass;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+FGameplayMessagePayloadRef FGameplayMessagePayloadArena::Allocate(const UScriptStruct* StructType, const void* MessageBytes)
+{
+	check(StructType && MessageBytes);
+
+	const int32 Alignment = FMath::Max<int32>(StructType->GetMinAlignment(), alignof(FGameplayMessagePayloadBlock));
+	const uint32 PayloadOffset = Align(sizeof(FGameplayMessagePayloadBlock), Alignment);
+	const SIZE_T TotalSize = PayloadOffset + StructType->GetStructureSize();
+
+	// Over-aligned types skip the pool, pooled blocks are all allocated with the same alignment
+	const int32 SizeClass = (Alignment <= PooledAlignment) ? GetSizeClass(TotalSize) : INDEX_NONE;
+
+	void* Memory = nullptr;
+	if (SizeClass != INDEX_NONE)
+	{
+		Memory = FreeBlocks[SizeClass].Pop();
+		if (Memory)
+		{
+			NumFreeBlocks[SizeClass].fetch_sub(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			Memory = FMemory::Malloc(GetSizeClassBytes(SizeClass), PooledAlignment);
+		}
+	}
+	else
+	{
+		Memory = FMemory::Malloc(TotalSize, Alignment);
+	}
+
+	FGameplayMessagePayloadBlock* Block = new (Memory) FGameplayMessagePayloadBlock();
+	Block->SizeClass = SizeClass;
+	Block->PayloadOffset = PayloadOffset;
+	Block->StructType = StructType;
+	Block->Arena = AsShared();
+
+	StructType->InitializeStruct(Block->GetPayload());
+	StructType->CopyScriptStruct(Block->GetPayload(), MessageBytes);
+
+	return FGameplayMessagePayloadRef(Block);
+}
+
+void FGameplayMessagePayloadArena::Free(FGameplayMessagePayloadBlock* Block)
+{
+	const int32 SizeClass = Block->SizeClass;
+
+	Block->StructType->DestroyStruct(Block->GetPayload());
+	Block->~FGameplayMessagePayloadBlock();
+
+	if ((SizeClass != INDEX_NONE) && (NumFreeBlocks[SizeClass].load(std::memory_order_relaxed) < UE::GameplayMessageSubsystem::MaxPooledPayloadBlocks))
+	{
+		NumFreeBlocks[SizeClass].fetch_add(1, std::memory_order_relaxed);
+		FreeBlocks[SizeClass].Push(Block);
+	}
+	else
+	{
+		FMemory::Free(Block);
+	}
+}
+
+SIZE_T FGameplayMessagePayloadArena::GetPooledBytes() const
+{
+	SIZE_T PooledBytes = 0;
+	for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+	{
+		PooledBytes += NumFreeBlocks[SizeClass].load(std::memory_order_relaxed) * GetSizeClassBytes(SizeClass);
+	}
+	return PooledBytes;
+}
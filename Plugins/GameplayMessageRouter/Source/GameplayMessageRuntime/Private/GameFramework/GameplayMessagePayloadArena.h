@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/LockFreeList.h"
+#include "GameFramework/GameplayMessagePayload.h"
+#include "Templates/SharedPointer.h"
+
+#include <atomic>
+
+/**
+ * Header of a pooled payload allocation, the payload itself follows at PayloadOffset
+ */
+struct FGameplayMessagePayloadBlock
+{
+	std::atomic<int32> RefCount = 1;
+	int32 SizeClass = INDEX_NONE;
+	uint32 PayloadOffset = 0;
+	const UScriptStruct* StructType = nullptr;
+
+	// Keeps the arena alive while the block is handed out, cleared when the block goes back to the pool
+	TSharedPtr<FGameplayMessagePayloadArena, ESPMode::ThreadSafe> Arena;
+
+	void* GetPayload() { return reinterpret_cast<uint8*>(this) + PayloadOffset; }
+};
+
+/**
+ * Pool of payload blocks bucketed by power of two size classes.  Allocation happens on the game thread when a message
+ * is broadcast, blocks can be returned from any thread.
+ */
+class FGameplayMessagePayloadArena : public TSharedFromThis<FGameplayMessagePayloadArena, ESPMode::ThreadSafe>
+{
+public:
+	~FGameplayMessagePayloadArena();
+
+	/** Copies the message into a pooled block */
+	FGameplayMessagePayloadRef Allocate(const UScriptStruct* StructType, const void* MessageBytes);
+
+	/** Destroys the payload of a block whose last reference was released, and pools or frees its memory */
+	void Free(FGameplayMessagePayloadBlock* Block);
+
+	/** @return the number of bytes currently held by the free lists */
+	SIZE_T GetPooledBytes() const;
+
+private:
+	static constexpr int32 MinSizeClassBytes = 64;
+	static constexpr int32 NumSizeClasses = 7;
+	static constexpr int32 PooledAlignment = 16;
+
+	static int32 GetSizeClass(SIZE_T Size);
+	static SIZE_T GetSizeClassBytes(int32 SizeClass) { return SIZE_T(MinSizeClassBytes) << SizeClass; }
+
+	TLockFreePointerListUnordered<FGameplayMessagePayloadBlock, PLATFORM_CACHE_LINE_SIZE> FreeBlocks[NumSizeClasses];
+	std::atomic<int32> NumFreeBlocks[NumSizeClasses] = {};
+};
@@ -4,8 +4,12 @@
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "GameplayMessagePayloadArena.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
 #include "UObject/ScriptMacros.h"
 #include "UObject/Stack.h"
+#include "UObject/UObjectIterator.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameplayMessageSubsystem)
 
@@ -19,6 +23,42 @@ namespace UE
 		static FAutoConsoleVariableRef CVarShouldLogMessages(TEXT("GameplayMessageSubsystem.LogMessages"),
 			ShouldLogMessages,
 			TEXT("Should messages broadcast through the gameplay message subsystem be logged?"));
+
+		static float CompactionInterval = 30.0f;
+		static FAutoConsoleVariableRef CVarCompactionInterval(TEXT("GameplayMessageSubsystem.Compaction.Interval"),
+			CompactionInterval,
+			TEXT("How often (in seconds) the listener map is checked for compaction, read when the subsystem initializes. 0 disables periodic compaction."));
+
+		static int32 CompactionChurnThreshold = 256;
+		static FAutoConsoleVariableRef CVarCompactionChurnThreshold(TEXT("GameplayMessageSubsystem.Compaction.ChurnThreshold"),
+			CompactionChurnThreshold,
+			TEXT("Number of listeners that must be registered or unregistered since the last compaction before the listener map is compacted again."));
+
+		static FAutoConsoleCommandWithOutputDevice DumpMemoryCommand(TEXT("GameplayMessageSubsystem.DumpMemory"),
+			TEXT("Reports the memory used by listeners of every gameplay message subsystem, per channel."),
+			FConsoleCommandWithOutputDeviceDelegate::CreateStatic([](FOutputDevice& Ar)
+			{
+				for (TObjectIterator<UGameplayMessageSubsystem> It; It; ++It)
+				{
+					if (!It->HasAnyFlags(RF_ClassDefaultObject))
+					{
+						It->DumpMemoryUsage(Ar);
+					}
+				}
+			}));
+
+		static FAutoConsoleCommand CompactCommand(TEXT("GameplayMessageSubsystem.Compact"),
+			TEXT("Immediately compacts the listener map of every gameplay message subsystem."),
+			FConsoleCommandDelegate::CreateStatic([]()
+			{
+				for (TObjectIterator<UGameplayMessageSubsystem> It; It; ++It)
+				{
+					if (!It->HasAnyFlags(RF_ClassDefaultObject))
+					{
+						It->CompactListenerMap();
+					}
+				}
+			}));
 	}
 }
 
@@ -55,9 +95,38 @@ bool UGameplayMessageSubsystem::HasInstance(const UObject* WorldContextObject)
 	return Router != nullptr;
 }
 
+void UGameplayMessageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UE::GameplayMessageSubsystem::CompactionInterval > 0.0f)
+	{
+		CompactionTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateUObject(this, &ThisClass::HandleCompactionTick),
+			UE::GameplayMessageSubsystem::CompactionInterval);
+	}
+}
+
 void UGameplayMessageSubsystem::Deinitialize()
 {
+	FTSTicker::GetCoreTicker().RemoveTicker(CompactionTickerHandle);
+	CompactionTickerHandle.Reset();
+
 	ListenerMap.Reset();
+	ListenerChurn = 0;
+
+	// Outstanding payload handles keep the arena alive until they're released
+	PayloadArena.Reset();
+
+	// Coroutines still waiting will never be resumed, detach them so destroying their frames later doesn't touch our memory
+	for (TPair<FGameplayTag, TUniquePtr<FGameplayMessageWaiterNode>>& Pair : WaiterMap)
+	{
+		while (Pair.Value->IsLinked())
+		{
+			Pair.Value->GetNext()->Unlink();
+		}
+	}
+	WaiterMap.Reset();
 
 	Super::Deinitialize();
 }
@@ -81,6 +150,9 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("BroadcastMessage(%s, %s, %s)"), pContextString ? **pContextString : *GetPathNameSafe(this), *Channel.ToString(), *HumanReadableMessage);
 	}
 
+	// Copied on demand the first time a listener wants a shared payload, then shared by all of them
+	FGameplayMessagePayloadRef SharedPayload;
+
 	// Broadcast the message
 	bool bOnInitialTag = true;
 	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
@@ -104,7 +176,23 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 					// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
 					if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
 					{
-						Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+						if (Listener.bWantsSharedPayload)
+						{
+							if (!SharedPayload.IsValid())
+							{
+								if (!PayloadArena.IsValid())
+								{
+									PayloadArena = MakeShared<FGameplayMessagePayloadArena, ESPMode::ThreadSafe>();
+								}
+								SharedPayload = PayloadArena->Allocate(StructType, MessageBytes);
+							}
+
+							Listener.ReceivedCallback(Channel, StructType, &SharedPayload);
+						}
+						else
+						{
+							Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+						}
 					}
 					else
 					{
@@ -119,6 +207,76 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 		}
 		bOnInitialTag = false;
 	}
+
+	ResumeWaitersInternal(Channel, StructType, MessageBytes);
+}
+
+void UGameplayMessageSubsystem::ResumeWaitersInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes)
+{
+	if (WaiterMap.Num() == 0)
+	{
+		return;
+	}
+
+	// Move every matching waiter to a local list before resuming anything, a resumed coroutine
+	// may wait again on the same channel or destroy other coroutines that are about to be resumed
+	FGameplayMessageWaiterNode ReadyList;
+
+	bool bOnInitialTag = true;
+	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		if (const TUniquePtr<FGameplayMessageWaiterNode>* pSentinel = WaiterMap.Find(Tag))
+		{
+			FGameplayMessageWaiterNode& Sentinel = **pSentinel;
+			for (FGameplayMessageWaiterNode* Waiter = Sentinel.GetNext(); Waiter != &Sentinel;)
+			{
+				FGameplayMessageWaiterNode* NextWaiter = Waiter->GetNext();
+
+				if (bOnInitialTag || (Waiter->MatchType == EGameplayMessageMatch::PartialMatch))
+				{
+					if (StructType->IsChildOf(Waiter->ListenerStructType))
+					{
+						Waiter->ListenerStructType->CopyScriptStruct(Waiter->PayloadStorage, MessageBytes);
+						Waiter->LinkBefore(ReadyList);
+					}
+					else
+					{
+						UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, waiter at %s was expecting type %s)"),
+							*Channel.ToString(),
+							*StructType->GetPathName(),
+							*Tag.ToString(),
+							*Waiter->ListenerStructType->GetPathName());
+					}
+				}
+
+				Waiter = NextWaiter;
+			}
+
+			if (!Sentinel.IsLinked())
+			{
+				WaiterMap.Remove(Tag);
+			}
+		}
+		bOnInitialTag = false;
+	}
+
+	while (ReadyList.IsLinked())
+	{
+		FGameplayMessageWaiterNode* Waiter = ReadyList.GetNext();
+		Waiter->Unlink();
+		Waiter->Continuation.resume();
+	}
+}
+
+void UGameplayMessageSubsystem::LinkWaiterInternal(FGameplayTag Channel, FGameplayMessageWaiterNode& Waiter)
+{
+	TUniquePtr<FGameplayMessageWaiterNode>& Sentinel = WaiterMap.FindOrAdd(Channel);
+	if (!Sentinel.IsValid())
+	{
+		Sentinel = MakeUnique<FGameplayMessageWaiterNode>();
+	}
+
+	Waiter.LinkBefore(*Sentinel);
 }
 
 void UGameplayMessageSubsystem::K2_BroadcastMessage(FGameplayTag Channel, const int32& Message)
@@ -144,7 +302,7 @@ DEFINE_FUNCTION(UGameplayMessageSubsystem::execK2_BroadcastMessage)
 	}
 }
 
-FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType)
+FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType, int32 CallbackCaptureSize, bool bWantsSharedPayload)
 {
 	FChannelListenerList& List = ListenerMap.FindOrAdd(Channel);
 
@@ -154,6 +312,10 @@ FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerIntern
 	Entry.bHadValidType = StructType != nullptr;
 	Entry.HandleID = ++List.HandleID;
 	Entry.MatchType = MatchType;
+	Entry.CallbackCaptureSize = CallbackCaptureSize;
+	Entry.bWantsSharedPayload = bWantsSharedPayload;
+
+	++ListenerChurn;
 
 	return FGameplayMessageListenerHandle(this, Channel, Entry.HandleID);
 }
@@ -179,7 +341,9 @@ void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel,
 		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == ID; });
 		if (MatchIndex != INDEX_NONE)
 		{
-			pList->Listeners.RemoveAtSwap(MatchIndex);
+			// Don't let the array shrink here, compaction takes care of that in bulk
+			pList->Listeners.RemoveAtSwap(MatchIndex, 1, /*bAllowShrinking=*/ false);
+			++ListenerChurn;
 		}
 
 		if (pList->Listeners.Num() == 0)
@@ -189,3 +353,105 @@ void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel,
 	}
 }
 
+bool UGameplayMessageSubsystem::HandleCompactionTick(float DeltaTime)
+{
+	if (ListenerChurn >= UE::GameplayMessageSubsystem::CompactionChurnThreshold)
+	{
+		CompactListenerMap();
+	}
+
+	return true;
+}
+
+void UGameplayMessageSubsystem::CompactListenerMap()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_UGameplayMessageSubsystem_CompactListenerMap);
+
+	const SIZE_T AllocatedBefore = ListenerMap.GetAllocatedSize();
+
+	for (TPair<FGameplayTag, FChannelListenerList>& Pair : ListenerMap)
+	{
+		TArray<FGameplayMessageListenerData>& Listeners = Pair.Value.Listeners;
+		if (Listeners.GetSlack() > Listeners.Num())
+		{
+			Listeners.Shrink();
+		}
+	}
+
+	// Removing channels leaves holes in the sparse storage, compact it and then size the hash for what's left
+	ListenerMap.Compact();
+	ListenerMap.Shrink();
+
+	WaiterMap.Compact();
+	WaiterMap.Shrink();
+
+	UE_LOG(LogGameplayMessageSubsystem, Verbose, TEXT("Compacted listener map of %s (%d channels, churn %d, map %llu -> %llu bytes)"),
+		*GetPathNameSafe(this), ListenerMap.Num(), ListenerChurn, (uint64)AllocatedBefore, (uint64)ListenerMap.GetAllocatedSize());
+
+	ListenerChurn = 0;
+}
+
+void UGameplayMessageSubsystem::DumpMemoryUsage(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("GameplayMessageSubsystem %s"), *GetPathNameSafe(this));
+	Ar.Logf(TEXT("  %-48s %9s %9s %12s %12s %8s %8s"), TEXT("Channel"), TEXT("Listeners"), TEXT("Capacity"), TEXT("ArrayBytes"), TEXT("CaptureBytes"), TEXT("Opaque"), TEXT("Waiters"));
+
+	SIZE_T TotalArrayBytes = 0;
+	SIZE_T TotalCaptureBytes = 0;
+	int32 TotalOpaque = 0;
+
+	for (const TPair<FGameplayTag, FChannelListenerList>& Pair : ListenerMap)
+	{
+		const TArray<FGameplayMessageListenerData>& Listeners = Pair.Value.Listeners;
+
+		// Listeners registered with a TFunction keep their captures where we can't measure them
+		SIZE_T CaptureBytes = 0;
+		int32 NumOpaque = 0;
+		for (const FGameplayMessageListenerData& Listener : Listeners)
+		{
+			if (Listener.CallbackCaptureSize == INDEX_NONE)
+			{
+				++NumOpaque;
+			}
+			else
+			{
+				CaptureBytes += Listener.CallbackCaptureSize;
+			}
+		}
+
+		int32 NumWaiters = 0;
+		if (const TUniquePtr<FGameplayMessageWaiterNode>* pSentinel = WaiterMap.Find(Pair.Key))
+		{
+			for (const FGameplayMessageWaiterNode* Waiter = (*pSentinel)->GetNext(); Waiter != pSentinel->Get(); Waiter = Waiter->GetNext())
+			{
+				++NumWaiters;
+			}
+		}
+
+		Ar.Logf(TEXT("  %-48s %9d %9d %12llu %12llu %8d %8d"),
+			*Pair.Key.ToString(),
+			Listeners.Num(),
+			Listeners.Max(),
+			(uint64)Listeners.GetAllocatedSize(),
+			(uint64)CaptureBytes,
+			NumOpaque,
+			NumWaiters);
+
+		TotalArrayBytes += Listeners.GetAllocatedSize();
+		TotalCaptureBytes += CaptureBytes;
+		TotalOpaque += NumOpaque;
+	}
+
+	const SIZE_T MapBytes = ListenerMap.GetAllocatedSize() + WaiterMap.GetAllocatedSize() + (WaiterMap.Num() * sizeof(FGameplayMessageWaiterNode));
+	const SIZE_T PooledPayloadBytes = PayloadArena.IsValid() ? PayloadArena->GetPooledBytes() : 0;
+
+	Ar.Logf(TEXT("  Channels: %d, Map: %llu bytes, Arrays: %llu bytes, Captures: %llu bytes (%d opaque listeners not included), Pooled payloads: %llu bytes, Total: %llu bytes, Churn since compaction: %d"),
+		ListenerMap.Num(),
+		(uint64)MapBytes,
+		(uint64)TotalArrayBytes,
+		(uint64)TotalCaptureBytes,
+		TotalOpaque,
+		(uint64)PooledPayloadBytes,
+		(uint64)(MapBytes + TotalArrayBytes + TotalCaptureBytes + PooledPayloadBytes),
+		ListenerChurn);
+}
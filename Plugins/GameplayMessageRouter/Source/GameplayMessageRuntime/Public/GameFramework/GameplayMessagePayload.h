@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/Class.h"
+
+class FGameplayMessagePayloadArena;
+class UScriptStruct;
+struct FGameplayMessagePayloadBlock;
+
+/**
+ * A ref-counted, immutable copy of a broadcast message payload.
+ *
+ * The copy is made once per broadcast from a pooled arena owned by the router, and shared by every deferred listener
+ * of that broadcast.  Handles can be copied and released from any thread, the payload is destroyed and its memory
+ * returned to the pool when the last handle goes away.
+ */
+/**
+ * 广播消息负载的引用计数不可变副本。
+ *
+ * 每次广播只从路由器拥有的池化内存区中复制一次，并由该广播的所有延迟监听器共享。
+ * 句柄可以在任何线程上复制和释放，当最后一个句柄消失时，负载会被销毁并且其内存会归还到池中。
+ */
+class GAMEPLAYMESSAGERUNTIME_API FGameplayMessagePayloadRef
+{
+public:
+	FGameplayMessagePayloadRef() = default;
+	FGameplayMessagePayloadRef(const FGameplayMessagePayloadRef& Other);
+	FGameplayMessagePayloadRef(FGameplayMessagePayloadRef&& Other);
+	FGameplayMessagePayloadRef& operator=(const FGameplayMessagePayloadRef& Other);
+	FGameplayMessagePayloadRef& operator=(FGameplayMessagePayloadRef&& Other);
+	~FGameplayMessagePayloadRef();
+
+	bool IsValid() const { return Block != nullptr; }
+
+	/** @return the type of the payload as it was broadcast, this may be a child of the type the listener registered with */
+	/** @return 广播时负载的类型，它可能是监听器注册类型的子类 */
+	const UScriptStruct* GetStructType() const;
+
+	const void* GetPayload() const;
+
+	void Reset();
+
+private:
+	// Takes ownership of a reference already added to the block
+	// 接管已添加到块上的一个引用
+	explicit FGameplayMessagePayloadRef(FGameplayMessagePayloadBlock* InBlock) : Block(InBlock) {}
+
+	FGameplayMessagePayloadBlock* Block = nullptr;
+
+	friend FGameplayMessagePayloadArena;
+};
+
+/**
+ * Typed view of a FGameplayMessagePayloadRef
+ */
+/**
+ * FGameplayMessagePayloadRef 的类型化视图
+ */
+template <typename FMessageStructType>
+class TGameplayMessagePayloadRef
+{
+public:
+	TGameplayMessagePayloadRef() = default;
+	explicit TGameplayMessagePayloadRef(FGameplayMessagePayloadRef InRef) : Ref(MoveTemp(InRef)) {}
+
+	bool IsValid() const { return Ref.IsValid(); }
+
+	const FMessageStructType& Get() const
+	{
+		check(IsValid());
+		return *static_cast<const FMessageStructType*>(Ref.GetPayload());
+	}
+
+	const FMessageStructType& operator*() const { return Get(); }
+	const FMessageStructType* operator->() const { return &Get(); }
+
+	const FGameplayMessagePayloadRef& GetUntyped() const { return Ref; }
+
+	void Reset() { Ref.Reset(); }
+
+private:
+	FGameplayMessagePayloadRef Ref;
+};
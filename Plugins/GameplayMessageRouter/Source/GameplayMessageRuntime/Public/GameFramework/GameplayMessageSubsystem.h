@@ -2,13 +2,18 @@
 
 #pragma once
 
+#include "GameFramework/GameplayMessagePayload.h"
 #include "GameFramework/GameplayMessageTypes2.h"
+#include "GameFramework/GameplayMessageWaiter.h"
+#include "Containers/Ticker.h"
 #include "GameplayTagContainer.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "UObject/WeakObjectPtr.h"
 
 #include "GameplayMessageSubsystem.generated.h"
 
+class FGameplayMessagePayloadArena;
+class FOutputDevice;
 class UGameplayMessageSubsystem;
 struct FFrame;
 
@@ -75,6 +80,16 @@ struct FGameplayMessageListenerData
 	// 围绕一些潜在问题添加一些日志记录和额外变量
 	TWeakObjectPtr<const UScriptStruct> ListenerStructType = nullptr;
 	bool bHadValidType = false;
+
+	// Size of the heap block ReceivedCallback keeps its callable in, including the user's captures,
+	// INDEX_NONE if the user passed a TFunction whose own captures live in another block we can't see
+	// ReceivedCallback 保存其可调用对象的堆块大小，包括用户捕获的状态，
+	// 如果用户传入的是 TFunction，它自己的捕获位于另一个无法看到的堆块中，此时为 INDEX_NONE
+	int32 CallbackCaptureSize = 0;
+
+	// If set ReceivedCallback is passed a pointer to a FGameplayMessagePayloadRef rather than the raw message bytes
+	// 如果设置，ReceivedCallback 接收的是指向 FGameplayMessagePayloadRef 的指针，而不是原始消息字节
+	bool bWantsSharedPayload = false;
 };
 
 /**
@@ -128,6 +143,7 @@ public:
 	static bool HasInstance(const UObject* WorldContextObject);
 
 	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 	//~End of USubsystem interface
 
@@ -166,16 +182,19 @@ public:
 	 *
 	 * @return 可用于取消注册此侦听器的句柄（通过在句柄上调用 Unregister() 或在路由器上调用 UnregisterListener）
 	 */
-	template <typename FMessageStructType>
-	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TFunction<void(FGameplayTag, const FMessageStructType&)>&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch)
+	template <typename FMessageStructType, typename FCallable,
+	          typename = std::enable_if_t<std::is_invocable_v<std::decay_t<FCallable>&, FGameplayTag, const FMessageStructType&>>>
+	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, FCallable&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch)
 	{
-		auto ThunkCallback = [InnerCallback = MoveTemp(Callback)](FGameplayTag ActualTag, const UScriptStruct* SenderStructType, const void* SenderPayload)
+		// Captured by value, so the size of the thunk includes whatever the user's callable captured
+		auto ThunkCallback = [InnerCallback = Forward<FCallable>(Callback)](FGameplayTag ActualTag, const UScriptStruct* SenderStructType, const void* SenderPayload) mutable
 		{
 			InnerCallback(ActualTag, *reinterpret_cast<const FMessageStructType*>(SenderPayload));
 		};
 
 		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-		return RegisterListenerInternal(Channel, ThunkCallback, StructType, MatchType);
+		const int32 CaptureSize = GetCallbackCaptureSize<decltype(ThunkCallback), FCallable>();
+		return RegisterListenerInternal(Channel, MoveTemp(ThunkCallback), StructType, MatchType, CaptureSize);
 	}
 
 	/**
@@ -244,12 +263,77 @@ public:
 			};
 
 			const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-			Handle = RegisterListenerInternal(Channel, ThunkCallback, StructType, Params.MatchType);
+			const int32 CaptureSize = GetCallbackCaptureSize<decltype(ThunkCallback), decltype(Params.OnMessageReceivedCallback)>();
+			Handle = RegisterListenerInternal(Channel, MoveTemp(ThunkCallback), StructType, Params.MatchType, CaptureSize);
 		}
 
 		return Handle;
 	}
 
+	/**
+	 * Register to receive messages on a specified channel as a shared, immutable payload handle
+	 * Use this for listeners that need the message after the callback returns (e.g., to forward it to worker tasks),
+	 * the payload is copied once per broadcast into a pooled block and shared by every listener holding the handle
+	 *
+	 * @param Channel			The message channel to listen to
+	 * @param Callback			Function to call with the payload handle when someone broadcasts a message, the handle may be kept and passed to other threads
+	 * @param MatchType			The rule used for matching the channel with broadcasted messages
+	 *
+	 * @return a handle that can be used to unregister this listener (either by calling Unregister() on the handle or calling UnregisterListener on the router)
+	 */
+	/**
+	 * 在指定的通道上注册，以共享的不可变负载句柄的形式接收消息
+	 * 适用于在回调返回后仍需要消息的监听器（例如，将其转发给工作任务），
+	 * 每次广播只会将负载复制一次到池化块中，并由所有持有该句柄的监听器共享
+	 *
+	 * @param Channel			要监听的消息通道
+	 * @param Callback			当有人广播消息时使用负载句柄调用的函数，该句柄可以被保留并传递给其他线程
+	 * @param MatchType			用于将通道与广播消息匹配的规则
+	 *
+	 * @return 可用于取消注册此侦听器的句柄（通过在句柄上调用 Unregister() 或在路由器上调用 UnregisterListener）
+	 */
+	template <typename FMessageStructType, typename FCallable,
+	          typename = std::enable_if_t<std::is_invocable_v<std::decay_t<FCallable>&, FGameplayTag, TGameplayMessagePayloadRef<FMessageStructType>>>>
+	FGameplayMessageListenerHandle RegisterSharedPayloadListener(FGameplayTag Channel, FCallable&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch)
+	{
+		auto ThunkCallback = [InnerCallback = Forward<FCallable>(Callback)](FGameplayTag ActualTag, const UScriptStruct* SenderStructType, const void* SenderPayload) mutable
+		{
+			InnerCallback(ActualTag, TGameplayMessagePayloadRef<FMessageStructType>(*reinterpret_cast<const FGameplayMessagePayloadRef*>(SenderPayload)));
+		};
+
+		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
+		const int32 CaptureSize = GetCallbackCaptureSize<decltype(ThunkCallback), FCallable>();
+		return RegisterListenerInternal(Channel, MoveTemp(ThunkCallback), StructType, MatchType, CaptureSize, /*bWantsSharedPayload=*/ true);
+	}
+
+	/**
+	 * Suspend the calling coroutine until the next message is broadcast on the specified channel
+	 * Unlike RegisterListener this does not allocate, the wait is tracked by a node living in the coroutine frame
+	 *
+	 *    const FMyMessage Message = co_await Router.NextMessage<FMyMessage>(Channel);
+	 *
+	 * @param Channel			The message channel to wait on
+	 * @param MatchType			The rule used for matching the channel with broadcasted messages
+	 *
+	 * @return an awaitable that resumes with a copy of the message payload, destroying the coroutine cancels the wait
+	 */
+	/**
+	 * 挂起调用的协程，直到在指定通道上广播下一条消息
+	 * 与 RegisterListener 不同，这不会分配内存，等待由位于协程帧中的节点跟踪
+	 *
+	 *    const FMyMessage Message = co_await Router.NextMessage<FMyMessage>(Channel);
+	 *
+	 * @param Channel			要等待的消息通道
+	 * @param MatchType			用于将通道与广播消息匹配的规则
+	 *
+	 * @return 一个可等待对象，恢复时返回消息负载的副本，销毁协程即可取消等待
+	 */
+	template <typename FMessageStructType>
+	TGameplayMessageAwaiter<FMessageStructType> NextMessage(FGameplayTag Channel, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch)
+	{
+		return TGameplayMessageAwaiter<FMessageStructType>(*this, Channel, MatchType);
+	}
+
 	/**
 	 * Remove a message listener previously registered by RegisterListener
 	 *
@@ -291,10 +375,59 @@ private:
 		FGameplayTag Channel, 
 		TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback,
 		const UScriptStruct* StructType,
-		EGameplayMessageMatch MatchType);
+		EGameplayMessageMatch MatchType,
+		int32 CallbackCaptureSize,
+		bool bWantsSharedPayload = false);
 
 	void UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID);
 
+	// Approximate size of the heap block a TFunction allocates for the thunk: the owned object's vtable pointer, then
+	// the thunk with the user's callable inside it.  A user callable that is itself a TFunction keeps its captures in
+	// a block of its own, which can't be measured from here
+	// TFunction 为 thunk 分配的堆块的近似大小：持有对象的虚表指针，然后是包含用户可调用对象的 thunk。
+	// 如果用户的可调用对象本身就是 TFunction，它的捕获位于自己的堆块中，这里无法测量
+	template <typename FThunk, typename FCallable>
+	static constexpr int32 GetCallbackCaptureSize()
+	{
+		return TIsTFunction<std::decay_t<FCallable>>::Value
+			? INDEX_NONE
+			: int32(Align(sizeof(void*), alignof(FThunk)) + sizeof(FThunk));
+	}
+
+public:
+	/**
+	 * Writes the memory used by the listener bookkeeping of this router, per channel, to the output device
+	 * Capture bytes are the heap blocks holding each listener's callable and the state it captured by value, not
+	 * including anything that state points to.  Listeners registered with a TFunction are counted as opaque instead
+	 */
+	/**
+	 * 将此路由器的监听器簿记所使用的内存（按通道）写入输出设备
+	 * 捕获字节数是保存每个监听器的可调用对象及其按值捕获的状态的堆块，不包括这些状态所指向的任何内容。
+	 * 使用 TFunction 注册的监听器无法测量，会单独计为不透明
+	 */
+	void DumpMemoryUsage(FOutputDevice& Ar) const;
+
+	/**
+	 * Shrinks over-allocated listener arrays and rehashes the listener map
+	 * This runs periodically once enough listeners have been added and removed, see GameplayMessageSubsystem.Compaction.*
+	 */
+	/**
+	 * 收缩过度分配的监听器数组并重新哈希监听器映射
+	 * 当添加和移除了足够多的监听器后会定期运行，参见 GameplayMessageSubsystem.Compaction.*
+	 */
+	void CompactListenerMap();
+
+private:
+	bool HandleCompactionTick(float DeltaTime);
+
+	// Internal helpers for coroutine waiters
+	// 用于协程等待者的内部辅助函数
+	void LinkWaiterInternal(FGameplayTag Channel, FGameplayMessageWaiterNode& Waiter);
+	void ResumeWaitersInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes);
+
+	template <typename FMessageStructType>
+	friend class TGameplayMessageAwaiter;
+
 private:
 	// List of all entries for a given channel
 	// 给定通道的所有条目列表
@@ -306,4 +439,24 @@ private:
 
 private:
 	TMap<FGameplayTag, FChannelListenerList> ListenerMap;
+
+	// Sentinels of the coroutine waiter lists, heap allocated so the nodes linked to them stay valid when the map grows
+	// 协程等待者链表的哨兵节点，在堆上分配，以便映射增长时链接到它们的节点仍然有效
+	TMap<FGameplayTag, TUniquePtr<FGameplayMessageWaiterNode>> WaiterMap;
+
+	// Number of listeners registered or unregistered since the last compaction
+	// 自上次压缩以来注册或注销的监听器数量
+	int32 ListenerChurn = 0;
+
+	FTSTicker::FDelegateHandle CompactionTickerHandle;
+
+	// Pool the shared payloads handed to RegisterSharedPayloadListener listeners are allocated from, created on first use
+	// 分配给 RegisterSharedPayloadListener 监听器的共享负载所使用的池，在首次使用时创建
+	TSharedPtr<FGameplayMessagePayloadArena, ESPMode::ThreadSafe> PayloadArena;
 };
+
+template <typename FMessageStructType>
+void TGameplayMessageAwaiter<FMessageStructType>::LinkWaiter(UGameplayMessageSubsystem& InRouter, FGameplayTag InChannel, FGameplayMessageWaiterNode& InNode)
+{
+	InRouter.LinkWaiterInternal(InChannel, InNode);
+}
@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/GameplayMessageTypes2.h"
+#include "GameplayTagContainer.h"
+
+#include <coroutine>
+
+class UGameplayMessageSubsystem;
+class UScriptStruct;
+
+/**
+ * Intrusive node for a single suspended "wait for the next message" request.
+ *
+ * Nodes live inside the awaiting coroutine frame and are linked into a circular list owned by the router, so waiting
+ * for a message does not allocate.  Unlinking only touches the neighbouring nodes, which is what makes it safe for
+ * the node to remove itself when the coroutine frame is destroyed while still suspended.
+ */
+/**
+ * 单个挂起的“等待下一条消息”请求的侵入式节点。
+ *
+ * 节点位于等待中的协程帧内，并链接到由路由器拥有的循环链表中，因此等待消息不会产生内存分配。
+ * 解除链接只会修改相邻节点，因此当协程帧在挂起期间被销毁时，节点可以安全地将自己移除。
+ */
+class GAMEPLAYMESSAGERUNTIME_API FGameplayMessageWaiterNode
+{
+public:
+	FGameplayMessageWaiterNode() = default;
+	~FGameplayMessageWaiterNode() { Unlink(); }
+
+	FGameplayMessageWaiterNode(const FGameplayMessageWaiterNode&) = delete;
+	FGameplayMessageWaiterNode& operator=(const FGameplayMessageWaiterNode&) = delete;
+
+	bool IsLinked() const { return Next != this; }
+
+	void LinkBefore(FGameplayMessageWaiterNode& Sentinel)
+	{
+		Unlink();
+		Prev = Sentinel.Prev;
+		Next = &Sentinel;
+		Sentinel.Prev->Next = this;
+		Sentinel.Prev = this;
+	}
+
+	void Unlink()
+	{
+		Prev->Next = Next;
+		Next->Prev = Prev;
+		Prev = this;
+		Next = this;
+	}
+
+	FGameplayMessageWaiterNode* GetNext() const { return Next; }
+
+private:
+	FGameplayMessageWaiterNode* Prev = this;
+	FGameplayMessageWaiterNode* Next = this;
+
+	// Only set on waiters, sentinels leave these empty
+	// 仅在等待者上设置，哨兵节点保持为空
+	std::coroutine_handle<> Continuation;
+	const UScriptStruct* ListenerStructType = nullptr;
+	void* PayloadStorage = nullptr;
+	EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch;
+
+	template <typename FMessageStructType>
+	friend class TGameplayMessageAwaiter;
+	friend UGameplayMessageSubsystem;
+};
+
+/**
+ * Awaitable returned by UGameplayMessageSubsystem::NextMessage.  The message payload is copied into the coroutine frame
+ * and returned from the co_await expression.
+ *
+ * If the coroutine is destroyed while suspended the waiter is unlinked automatically.  If the router is deinitialized
+ * first the coroutine is never resumed, and must be destroyed by whoever owns it.
+ */
+/**
+ * UGameplayMessageSubsystem::NextMessage 返回的可等待对象。消息负载会被复制到协程帧中，并作为 co_await 表达式的结果返回。
+ *
+ * 如果协程在挂起期间被销毁，等待者会自动解除链接。如果路由器先被反初始化，协程将永远不会被恢复，必须由其拥有者销毁。
+ */
+template <typename FMessageStructType>
+class TGameplayMessageAwaiter
+{
+public:
+	TGameplayMessageAwaiter(UGameplayMessageSubsystem& InRouter, FGameplayTag InChannel, EGameplayMessageMatch InMatchType)
+		: Router(InRouter)
+		, Channel(InChannel)
+	{
+		Node.MatchType = InMatchType;
+	}
+
+	TGameplayMessageAwaiter(const TGameplayMessageAwaiter&) = delete;
+	TGameplayMessageAwaiter& operator=(const TGameplayMessageAwaiter&) = delete;
+
+	bool await_ready() const { return false; }
+
+	void await_suspend(std::coroutine_handle<> Handle)
+	{
+		Node.Continuation = Handle;
+		Node.ListenerStructType = TBaseStructure<FMessageStructType>::Get();
+		Node.PayloadStorage = &Payload;
+		LinkWaiter(Router, Channel, Node);
+	}
+
+	FMessageStructType await_resume()
+	{
+		return MoveTemp(Payload);
+	}
+
+private:
+	static void LinkWaiter(UGameplayMessageSubsystem& InRouter, FGameplayTag InChannel, FGameplayMessageWaiterNode& InNode);
+
+	UGameplayMessageSubsystem& Router;
+	FGameplayTag Channel;
+	FMessageStructType Payload;
+	FGameplayMessageWaiterNode Node;
+};
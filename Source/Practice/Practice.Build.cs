@@ -10,6 +10,17 @@ public class Practice : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] { "EnhancedInput", "Niagara", "AIModule", "AsyncMixin", "XmlParser", "Json" });
 
+		// 图片转换直接调用 libjpeg-turbo 编码，省去 IImageWrapper::SetRaw 复制的一份像素，与 ImageWrapper 模块使用它的平台一致
+		if (Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Mac || Target.IsInPlatformGroup(UnrealPlatformGroup.Unix))
+		{
+			AddEngineThirdPartyPrivateStaticDependencies(Target, "LibJpegTurbo");
+			PrivateDefinitions.Add("PRACTICE_WITH_LIBJPEGTURBO=1");
+		}
+		else
+		{
+			PrivateDefinitions.Add("PRACTICE_WITH_LIBJPEGTURBO=0");
+		}
+
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 		
@@ -0,0 +1,598 @@
+﻿#include "AsyncMixinBenchmark.h"
+
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AsyncMixin.h"
+#include "CoreGlobals.h"
+#include "Curves/CurveFloat.h"
+#include "Dom/JsonObject.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+#include <atomic>
+
+// 模拟一个列表条目，OnFinishedLoading 时记录这一轮的延迟
+class FBenchmarkScope : public FAsyncScope
+{
+public:
+	explicit FBenchmarkScope(FAsyncMixinBenchmark& InBenchmark)
+		: Benchmark(InBenchmark)
+	{
+	}
+
+	// 开始新一轮加载前调用，返回上一轮是否还没完成就被取消了
+	bool BeginCycle()
+	{
+		const bool bWasPending = bPending;
+		CancelAsyncLoading();
+
+		RequestTime = FPlatformTime::Seconds();
+		bPending = true;
+		return bWasPending;
+	}
+
+	bool IsPending() const { return bPending; }
+
+protected:
+	virtual void OnFinishedLoading() override
+	{
+		if (bPending)
+		{
+			bPending = false;
+			Benchmark.RecordCompletion(RequestTime);
+		}
+	}
+
+private:
+	FAsyncMixinBenchmark& Benchmark;
+	double RequestTime = 0.0;
+	bool bPending = false;
+};
+
+// 统计分配次数的 GMalloc 代理，所有调用都转发给原来的分配器，测试期间临时替换 GMalloc
+class FCountingMalloc final : public FMalloc
+{
+public:
+	void Install()
+	{
+		check(Inner == nullptr);
+		Inner = GMalloc;
+		GMalloc = this;
+	}
+
+	void Uninstall()
+	{
+		// 其他线程可能还在调用这个代理，它本身是静态对象，转发的目标也一直有效
+		check(GMalloc == this);
+		GMalloc = Inner;
+	}
+
+	uint64 GetNumAllocations() const { return NumAllocations.load(std::memory_order_relaxed); }
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		NumAllocations.fetch_add(1, std::memory_order_relaxed);
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+	{
+		NumAllocations.fetch_add(1, std::memory_order_relaxed);
+		return Inner->TryMalloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		// Realloc(nullptr) 是一次新的分配
+		if (Original == nullptr)
+		{
+			NumAllocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Original == nullptr)
+		{
+			NumAllocations.fetch_add(1, std::memory_order_relaxed);
+		}
+		return Inner->TryRealloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+	virtual void UpdateStats() override { Inner->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+	virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+private:
+	FMalloc* Inner = nullptr;
+	std::atomic<uint64> NumAllocations = 0;
+};
+
+namespace AsyncMixinBenchmark
+{
+	static TSharedPtr<FAsyncMixinBenchmark> RunningBenchmark;
+
+	// 生成的包挂载的根路径
+	static const TCHAR* GeneratedRoot = TEXT("/AsyncMixinBench/");
+
+	// 不销毁，卸载后仍可能有线程在调用它
+	static FCountingMalloc& GetCountingMalloc()
+	{
+		static FCountingMalloc* CountingMalloc = new FCountingMalloc();
+		return *CountingMalloc;
+	}
+
+	static double Percentile(TArray<double> Values, double Fraction)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+		return Values[Index];
+	}
+
+	static void AddDistribution(const TSharedRef<FJsonObject>& Results, const FString& Name, const TArray<double>& Values)
+	{
+		double Sum = 0.0;
+		for (double Value : Values)
+		{
+			Sum += Value;
+		}
+
+		Results->SetNumberField(Name + TEXT(".Mean"), Values.Num() > 0 ? Sum / Values.Num() : 0.0);
+		Results->SetNumberField(Name + TEXT(".P50"), Percentile(Values, 0.50));
+		Results->SetNumberField(Name + TEXT(".P90"), Percentile(Values, 0.90));
+		Results->SetNumberField(Name + TEXT(".P99"), Percentile(Values, 0.99));
+		Results->SetNumberField(Name + TEXT(".Max"), Percentile(Values, 1.0));
+	}
+
+	static FAutoConsoleCommand CmdBench(
+		TEXT("AsyncMixin.Bench"),
+		TEXT("AsyncMixin 负载测试。参数：Scopes= Frames= ChurnPerFrame= PathsPerLoad= Dummies= DiskPercent= DiskRoot= DiskAssets= DiskKeys= GCInterval= DrainTimeout= Output= Baseline= Tolerance= Quit"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (RunningBenchmark.IsValid() && RunningBenchmark->IsRunning())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("AsyncMixin.Bench 已经在运行"));
+				return;
+			}
+
+			RunningBenchmark = MakeShared<FAsyncMixinBenchmark>(FAsyncMixinBenchmark::FSettings::Parse(FString::Join(Args, TEXT(" "))));
+			RunningBenchmark->Start();
+		}));
+}
+
+FAsyncMixinBenchmark::FSettings FAsyncMixinBenchmark::FSettings::Parse(const FString& Params)
+{
+	FSettings Settings;
+	FParse::Value(*Params, TEXT("Scopes="), Settings.NumScopes);
+	FParse::Value(*Params, TEXT("Frames="), Settings.NumFrames);
+	FParse::Value(*Params, TEXT("ChurnPerFrame="), Settings.ChurnPerFrame);
+	FParse::Value(*Params, TEXT("PathsPerLoad="), Settings.PathsPerLoad);
+	FParse::Value(*Params, TEXT("Dummies="), Settings.NumDummyAssets);
+	FParse::Value(*Params, TEXT("DiskPercent="), Settings.DiskAssetPercent);
+	FParse::Value(*Params, TEXT("DiskRoot="), Settings.DiskRoot);
+	FParse::Value(*Params, TEXT("DiskAssets="), Settings.NumDiskAssets);
+	FParse::Value(*Params, TEXT("DiskKeys="), Settings.DiskAssetKeys);
+	FParse::Value(*Params, TEXT("GCInterval="), Settings.GCInterval);
+	FParse::Value(*Params, TEXT("DrainTimeout="), Settings.DrainTimeout);
+	FParse::Value(*Params, TEXT("Output="), Settings.OutputPath);
+	FParse::Value(*Params, TEXT("Baseline="), Settings.BaselinePath);
+	FParse::Value(*Params, TEXT("Tolerance="), Settings.Tolerance);
+
+	TArray<FString> Tokens;
+	Params.ParseIntoArrayWS(Tokens);
+	Settings.bQuit = Tokens.Contains(TEXT("Quit"));
+
+	Settings.NumScopes = FMath::Max(Settings.NumScopes, 1);
+	Settings.NumDummyAssets = FMath::Max(Settings.NumDummyAssets, 1);
+	Settings.ChurnPerFrame = FMath::Clamp(Settings.ChurnPerFrame, 0, Settings.NumScopes);
+	Settings.PathsPerLoad = FMath::Max(Settings.PathsPerLoad, 1);
+	Settings.DiskAssetPercent = FMath::Clamp(Settings.DiskAssetPercent, 0, 100);
+	Settings.NumDiskAssets = FMath::Max(Settings.NumDiskAssets, 1);
+	Settings.DiskAssetKeys = FMath::Max(Settings.DiskAssetKeys, 0);
+	Settings.GCInterval = FMath::Max(Settings.GCInterval, 0);
+
+	if (Settings.OutputPath.IsEmpty())
+	{
+		Settings.OutputPath = FPaths::ProjectSavedDir() / TEXT("AsyncMixin") / TEXT("Benchmark.json");
+	}
+
+	return Settings;
+}
+
+FAsyncMixinBenchmark::FAsyncMixinBenchmark(const FSettings& InSettings)
+	: Settings(InSettings)
+	, Random(0x4153594E)
+{
+}
+
+FAsyncMixinBenchmark::~FAsyncMixinBenchmark()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	if (bCountingAllocations)
+	{
+		AsyncMixinBenchmark::GetCountingMalloc().Uninstall();
+	}
+}
+
+void FAsyncMixinBenchmark::CreateDummyAssets()
+{
+	// 常驻内存的假资源，加载它们只会走 FAsyncMixin 自身的逻辑，用来衡量框架本身的开销
+	for (int32 Index = 0; Index < Settings.NumDummyAssets; ++Index)
+	{
+		const FString PackageName = FString::Printf(TEXT("/Temp/AsyncMixinBench/Dummy_%d"), Index);
+		UPackage* Package = CreatePackage(*PackageName);
+		UCurveFloat* Dummy = NewObject<UCurveFloat>(Package, *FString::Printf(TEXT("Dummy_%d"), Index), RF_Public | RF_Standalone | RF_Transient);
+		Dummy->AddToRoot();
+
+		DummyAssets.Add(Dummy);
+		DummyPaths.Add(FSoftObjectPath(Dummy));
+	}
+}
+
+void FAsyncMixinBenchmark::GatherDiskAssets()
+{
+	if (Settings.DiskAssetPercent <= 0)
+	{
+		return;
+	}
+
+	if (Settings.DiskRoot.IsEmpty())
+	{
+		GenerateDiskAssets();
+		return;
+	}
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(FName(*Settings.DiskRoot));
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	UAssetManager::Get().GetAssetRegistry().GetAssets(Filter, Assets);
+
+	for (const FAssetData& Asset : Assets)
+	{
+		if (!Asset.IsAssetLoaded() && (DiskPaths.Num() < Settings.NumDiskAssets))
+		{
+			DiskPaths.Add(Asset.GetSoftObjectPath());
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("AsyncMixin.Bench: %s 下找到 %d 个未加载的资源"), *Settings.DiskRoot, DiskPaths.Num());
+}
+
+void FAsyncMixinBenchmark::GenerateDiskAssets()
+{
+#if WITH_EDITOR
+	using namespace AsyncMixinBenchmark;
+
+	GeneratedContentDir = FPaths::ProjectSavedDir() / TEXT("AsyncMixin") / TEXT("BenchContent/");
+	FPackageName::RegisterMountPoint(GeneratedRoot, GeneratedContentDir);
+
+	TArray<FString> Filenames;
+	for (int32 Index = 0; Index < Settings.NumDiskAssets; ++Index)
+	{
+		const FString AssetName = FString::Printf(TEXT("Disk_%d"), Index);
+		const FString PackageName = FString(GeneratedRoot) + AssetName;
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+		UPackage* Package = CreatePackage(*PackageName);
+		UCurveFloat* Asset = NewObject<UCurveFloat>(Package, *AssetName, RF_Public | RF_Standalone);
+		for (int32 Key = 0; Key < Settings.DiskAssetKeys; ++Key)
+		{
+			Asset->FloatCurve.AddKey(float(Key), float((Index + Key) % 97));
+		}
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		if (UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+		{
+			Filenames.Add(Filename);
+			DiskPaths.Add(FSoftObjectPath(Asset));
+		}
+
+		// 保存后就丢弃，测试时从磁盘读取
+		Asset->ClearFlags(RF_Standalone);
+		Asset->MarkAsGarbage();
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	// 准入控制和取消按资产注册表中的磁盘大小计算字节数
+	UAssetManager::Get().GetAssetRegistry().ScanFilesSynchronous(Filenames, /*bForceRescan*/true);
+
+	UE_LOG(LogTemp, Display, TEXT("AsyncMixin.Bench: 在 %s 下生成了 %d 个包"), *GeneratedContentDir, DiskPaths.Num());
+#else
+	UE_LOG(LogTemp, Warning, TEXT("AsyncMixin.Bench: 只有编辑器版本可以生成磁盘上的包，请用 DiskRoot= 指定已有的资源"));
+#endif
+}
+
+const FSoftObjectPath& FAsyncMixinBenchmark::PickPath()
+{
+	if ((DiskPaths.Num() > 0) && (Random.RandRange(1, 100) <= Settings.DiskAssetPercent))
+	{
+		return DiskPaths[Random.RandRange(0, DiskPaths.Num() - 1)];
+	}
+
+	return DummyPaths[Random.RandRange(0, DummyPaths.Num() - 1)];
+}
+
+void FAsyncMixinBenchmark::Start()
+{
+	UE_LOG(LogTemp, Display, TEXT("AsyncMixin.Bench: %d scopes, %d frames, %d churn/frame, %d paths/load, %d%% disk from %s"),
+	       Settings.NumScopes, Settings.NumFrames, Settings.ChurnPerFrame, Settings.PathsPerLoad, Settings.DiskAssetPercent,
+	       Settings.DiskRoot.IsEmpty() ? AsyncMixinBenchmark::GeneratedRoot : *Settings.DiskRoot);
+
+	CreateDummyAssets();
+	GatherDiskAssets();
+
+	Scopes.Reserve(Settings.NumScopes);
+	for (int32 Index = 0; Index < Settings.NumScopes; ++Index)
+	{
+		Scopes.Add(MakeUnique<FBenchmarkScope>(*this));
+	}
+
+	FrameMs.Reserve(Settings.NumFrames);
+	ChurnMs.Reserve(Settings.NumFrames);
+	AllocsPerFrame.Reserve(Settings.NumFrames);
+	ActiveTickers.Reserve(Settings.NumFrames);
+	LatencyMs.Reserve(int64(Settings.NumFrames) * Settings.ChurnPerFrame);
+
+	// 用 -trace=memalloc 录制时可以按这两个书签截取这段时间，查看具体是哪些分配
+	TRACE_BOOKMARK(TEXT("AsyncMixin.Bench Begin"));
+	IConsoleManager::Get().ProcessUserConsoleInput(TEXT("AsyncMixin.ResetTimings"), *GLog, nullptr);
+
+	FCountingMalloc& CountingMalloc = AsyncMixinBenchmark::GetCountingMalloc();
+	CountingMalloc.Install();
+	bCountingAllocations = true;
+	StartAllocations = LastAllocations = CountingMalloc.GetNumAllocations();
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	StartUsedPhysical = PeakUsedPhysical = MemoryStats.UsedPhysical;
+	StartUsedVirtual = PeakUsedVirtual = MemoryStats.UsedVirtual;
+	StartNumObjects = PeakNumObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FAsyncMixinBenchmark::Tick));
+}
+
+void FAsyncMixinBenchmark::RecordCompletion(double RequestTime)
+{
+	LatencyMs.Add((FPlatformTime::Seconds() - RequestTime) * 1000.0);
+}
+
+void FAsyncMixinBenchmark::Churn()
+{
+	const double ChurnStart = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Settings.ChurnPerFrame; ++Index)
+	{
+		FBenchmarkScope& Scope = *Scopes[Random.RandRange(0, Scopes.Num() - 1)];
+		if (Scope.BeginCycle())
+		{
+			++NumCanceled;
+		}
+
+		for (int32 PathIndex = 0; PathIndex < Settings.PathsPerLoad; ++PathIndex)
+		{
+			Scope.AsyncLoad(PickPath(), FSimpleDelegate::CreateLambda([] {}));
+		}
+		Scope.StartAsyncLoading();
+		++NumCycles;
+	}
+
+	ChurnMs.Add((FPlatformTime::Seconds() - ChurnStart) * 1000.0);
+}
+
+bool FAsyncMixinBenchmark::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FAsyncMixinBenchmark_Tick);
+
+	const double Now = FPlatformTime::Seconds();
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, MemoryStats.UsedPhysical);
+	PeakUsedVirtual = FMath::Max<uint64>(PeakUsedVirtual, MemoryStats.UsedVirtual);
+	PeakNumObjects = FMath::Max(PeakNumObjects, GUObjectArray.GetObjectArrayNumMinusAvailable());
+
+	const uint64 Allocations = AsyncMixinBenchmark::GetCountingMalloc().GetNumAllocations();
+	const uint64 LastFrameAllocations = Allocations - LastAllocations;
+	LastAllocations = Allocations;
+
+	if (Frame < Settings.NumFrames)
+	{
+		// GGameThreadTime 是上一帧游戏线程的耗时，第一帧的上一帧里包含了准备工作，不计入
+		if (Frame > 0)
+		{
+			FrameMs.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+			AllocsPerFrame.Add(double(LastFrameAllocations));
+		}
+		ActiveTickers.Add(FAsyncMixin::GetNumActiveTickers());
+
+		// 回收已经没有 Scope 引用的磁盘资源，之后再挑到它们时会重新读取
+		if ((DiskPaths.Num() > 0) && (Settings.GCInterval > 0) && (Frame > 0) && (Frame % Settings.GCInterval == 0))
+		{
+			GEngine->ForceGarbageCollection(/*bFullPurge*/true);
+		}
+
+		Churn();
+
+		if (++Frame == Settings.NumFrames)
+		{
+			ChurnEndTime = Now;
+		}
+		return true;
+	}
+
+	const bool bAnyPending = Scopes.ContainsByPredicate([](const TUniquePtr<FBenchmarkScope>& Scope) { return Scope->IsPending(); });
+	if (bAnyPending && (Now - ChurnEndTime < Settings.DrainTimeout))
+	{
+		return true;
+	}
+
+	TickerHandle.Reset();
+	Finish();
+	return false;
+}
+
+void FAsyncMixinBenchmark::Finish()
+{
+	TRACE_BOOKMARK(TEXT("AsyncMixin.Bench End"));
+
+	AsyncMixinBenchmark::GetCountingMalloc().Uninstall();
+	bCountingAllocations = false;
+	NumAllocations = LastAllocations - StartAllocations;
+
+	int32 NumStuck = 0;
+	for (const TUniquePtr<FBenchmarkScope>& Scope : Scopes)
+	{
+		NumStuck += Scope->IsPending() ? 1 : 0;
+	}
+
+	if (NumStuck > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AsyncMixin.Bench: %d 个 Scope 在 %.1f 秒内没有完成加载"), NumStuck, Settings.DrainTimeout);
+	}
+
+	Report();
+	Cleanup();
+}
+
+void FAsyncMixinBenchmark::Report()
+{
+	using namespace AsyncMixinBenchmark;
+
+	const TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	AddDistribution(Results, TEXT("FrameMs"), FrameMs);
+	AddDistribution(Results, TEXT("ChurnMs"), ChurnMs);
+	AddDistribution(Results, TEXT("LatencyMs"), LatencyMs);
+	AddDistribution(Results, TEXT("AllocsPerFrame"), AllocsPerFrame);
+	AddDistribution(Results, TEXT("ActiveTickers"), ActiveTickers);
+	Results->SetNumberField(TEXT("Allocs"), double(NumAllocations));
+	Results->SetNumberField(TEXT("AllocsPerCycle"), NumCycles > 0 ? double(NumAllocations) / NumCycles : 0.0);
+	Results->SetNumberField(TEXT("ActiveTickersAfterDrain"), FAsyncMixin::GetNumActiveTickers());
+	Results->SetNumberField(TEXT("PeakMemoryDeltaMB"), (double(PeakUsedPhysical) - double(StartUsedPhysical)) / (1024.0 * 1024.0));
+	Results->SetNumberField(TEXT("PeakVirtualDeltaMB"), (double(PeakUsedVirtual) - double(StartUsedVirtual)) / (1024.0 * 1024.0));
+	Results->SetNumberField(TEXT("PeakObjectDelta"), PeakNumObjects - StartNumObjects);
+	Results->SetNumberField(TEXT("Cycles"), double(NumCycles));
+	Results->SetNumberField(TEXT("Canceled"), double(NumCanceled));
+	Results->SetNumberField(TEXT("Completed"), LatencyMs.Num());
+	Results->SetNumberField(TEXT("DiskPaths"), DiskPaths.Num());
+
+	UE_LOG(LogTemp, Display, TEXT("AsyncMixin.Bench 结果："));
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Results->Values)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %-20s %12.3f"), *Pair.Key, Pair.Value->AsNumber());
+	}
+	IConsoleManager::Get().ProcessUserConsoleInput(TEXT("AsyncMixin.DumpTimings"), *GLog, nullptr);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Results, Writer);
+	if (FFileHelper::SaveStringToFile(Json, *Settings.OutputPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("AsyncMixin.Bench: 结果已写入 %s"), *Settings.OutputPath);
+	}
+
+	bool bPassed = true;
+
+	FString BaselineJson;
+	TSharedPtr<FJsonObject> Baseline;
+	if (!Settings.BaselinePath.IsEmpty()
+		&& FFileHelper::LoadFileToString(BaselineJson, *Settings.BaselinePath)
+		&& FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline)
+		&& Baseline.IsValid())
+	{
+		// 以下指标越小越好，加一点绝对余量，避免接近 0 的指标因为噪声被判定为退化
+		static const TCHAR* ComparedMetrics[] = {
+			TEXT("FrameMs.P50"), TEXT("FrameMs.P99"), TEXT("ChurnMs.P50"), TEXT("ChurnMs.P99"),
+			TEXT("LatencyMs.P50"), TEXT("LatencyMs.P99"), TEXT("AllocsPerFrame.P50"), TEXT("AllocsPerFrame.P99"),
+			TEXT("AllocsPerCycle"), TEXT("ActiveTickers.Max"), TEXT("ActiveTickersAfterDrain"),
+			TEXT("PeakMemoryDeltaMB"), TEXT("PeakVirtualDeltaMB"), TEXT("PeakObjectDelta")
+		};
+
+		for (const TCHAR* Metric : ComparedMetrics)
+		{
+			double BaselineValue = 0.0;
+			if (!Baseline->TryGetNumberField(Metric, BaselineValue))
+			{
+				continue;
+			}
+
+			const double Value = Results->GetNumberField(Metric);
+			const double Limit = BaselineValue * (1.0 + Settings.Tolerance / 100.0) + 0.05;
+			const bool bRegressed = Value > Limit;
+			bPassed &= !bRegressed;
+
+			UE_LOG(LogTemp, Display, TEXT("  %-20s 基线 %10.3f 当前 %10.3f %s"), Metric, BaselineValue, Value, bRegressed ? TEXT("退化") : TEXT(""));
+		}
+
+		if (bPassed)
+		{
+			UE_LOG(LogTemp, Display, TEXT("AsyncMixin.Bench: 与基线 %s 相比没有超过 %.1f%% 的退化"), *Settings.BaselinePath, Settings.Tolerance);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("AsyncMixin.Bench: 与基线 %s 相比有指标退化超过 %.1f%%"), *Settings.BaselinePath, Settings.Tolerance);
+		}
+	}
+	else if (!Settings.BaselinePath.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AsyncMixin.Bench: 无法读取基线 %s"), *Settings.BaselinePath);
+	}
+
+	if (Settings.bQuit)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+	}
+}
+
+void FAsyncMixinBenchmark::Cleanup()
+{
+	// 销毁 Scope 会取消它们尚未完成的加载
+	Scopes.Reset();
+
+	for (const TWeakObjectPtr<UObject>& Dummy : DummyAssets)
+	{
+		if (UObject* Object = Dummy.Get())
+		{
+			Object->RemoveFromRoot();
+			Object->ClearFlags(RF_Standalone);
+			Object->MarkAsGarbage();
+		}
+	}
+	DummyAssets.Reset();
+
+	// 生成的包留在磁盘上，下次运行时覆盖
+	if (!GeneratedContentDir.IsEmpty())
+	{
+		FPackageName::UnRegisterMountPoint(AsyncMixinBenchmark::GeneratedRoot, GeneratedContentDir);
+		GeneratedContentDir.Reset();
+	}
+}
@@ -0,0 +1,139 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class FBenchmarkScope;
+
+/**
+ * AsyncMixin 的负载测试，模拟大量列表条目被反复复用的情况：每帧随机挑选一批 FAsyncScope，
+ * 依次执行 CancelAsyncLoading → AsyncLoad → StartAsyncLoading。
+ *
+ * 通过控制台命令 AsyncMixin.Bench 启动，可以在无头模式下运行，例如：
+ *   UnrealEditor-Cmd UnrealPractice.uproject -game -nullrhi -unattended -ExecCmds="AsyncMixin.Bench Scopes=2000 Frames=600 Quit"
+ *
+ * 结果写入 Saved/AsyncMixin/Benchmark.json，指定 Baseline= 时与基线比较，任何指标退化超过 Tolerance= 百分比即判定为失败，
+ * 配合 Quit 时以非零退出码退出，可以作为接受或拒绝 FAsyncMixin 修改的依据。
+ *
+ * 加载的路径有两种来源，不同的组合覆盖不同的指标：
+ *   - 常驻的假资源（DiskPercent=0）：加载立即完成，只衡量 FAsyncMixin 自身的开销，即 ChurnMs、AllocsPerFrame、
+ *     AllocsPerCycle 和 ActiveTickers；LatencyMs 只包含调度延迟，不会经过 IO、准入控制和取消正在读取的包。
+ *   - 磁盘上的包（默认 DiskPercent=25）：不指定 DiskRoot= 时在 Saved/AsyncMixin/BenchContent 下生成 DiskAssets= 个真实的包，
+ *     挂载到 /AsyncMixinBench/ 并注册到资产注册表。LatencyMs 包含真实的读取，同时覆盖按磁盘大小的准入控制、
+ *     多个 Scope 请求同一个包时的合并，以及 Canceled 中取消正在读取的请求；PeakMemoryDeltaMB 和 PeakObjectDelta
+ *     包含加载进来的包。每 GCInterval= 帧强制 GC 一次，回收不再被引用的包，让它们之后重新从磁盘读取，
+ *     因此 FrameMs 的 P99 和 Max 包含 GC 的帧。指定 DiskRoot= 时改为使用该目录下已有的未加载资源。
+ */
+class FAsyncMixinBenchmark : public TSharedFromThis<FAsyncMixinBenchmark>
+{
+public:
+	struct FSettings
+	{
+		// 同时存在的 FAsyncScope 数量
+		int32 NumScopes = 2000;
+
+		// 产生负载的帧数
+		int32 NumFrames = 600;
+
+		// 每帧重新开始加载的 Scope 数量
+		int32 ChurnPerFrame = 200;
+
+		// 每个 Scope 每轮请求的路径数量
+		int32 PathsPerLoad = 4;
+
+		// 在内存中生成的假资源数量
+		int32 NumDummyAssets = 512;
+
+		// 从磁盘加载的路径所占的百分比，0 表示只加载常驻的假资源
+		int32 DiskAssetPercent = 25;
+
+		// 为空时生成磁盘上的包，否则从这个目录下挑选已有的未加载资源
+		FString DiskRoot;
+
+		// 生成的包的数量，以及每个包里曲线的关键帧数量，后者决定包的大小
+		int32 NumDiskAssets = 512;
+		int32 DiskAssetKeys = 1024;
+
+		// 每隔多少帧强制 GC 一次，让加载过的磁盘资源被回收后重新读取，0 表示不 GC
+		int32 GCInterval = 60;
+
+		// 负载结束后等待未完成加载的最长秒数
+		float DrainTimeout = 10.0f;
+
+		FString OutputPath;
+		FString BaselinePath;
+
+		// 相对基线允许的退化百分比
+		float Tolerance = 10.0f;
+
+		// 结束后退出进程，基线比较失败时退出码为 1
+		bool bQuit = false;
+
+		static FSettings Parse(const FString& Params);
+	};
+
+	explicit FAsyncMixinBenchmark(const FSettings& InSettings);
+	~FAsyncMixinBenchmark();
+
+	void Start();
+
+	bool IsRunning() const { return TickerHandle.IsValid(); }
+
+	/** 由 FBenchmarkScope 在一轮加载完成时调用 */
+	void RecordCompletion(double RequestTime);
+
+private:
+	bool Tick(float DeltaTime);
+	void Churn();
+	void Finish();
+	void Report();
+	void Cleanup();
+
+	void CreateDummyAssets();
+	void GatherDiskAssets();
+	void GenerateDiskAssets();
+	const FSoftObjectPath& PickPath();
+
+	FSettings Settings;
+
+	TArray<TUniquePtr<FBenchmarkScope>> Scopes;
+	TArray<TWeakObjectPtr<UObject>> DummyAssets;
+	TArray<FSoftObjectPath> DummyPaths;
+	TArray<FSoftObjectPath> DiskPaths;
+	FRandomStream Random;
+
+	// 生成的包所在的目录，挂载期间不为空
+	FString GeneratedContentDir;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	int32 Frame = 0;
+	double ChurnEndTime = 0.0;
+
+	// 每帧的游戏线程耗时（GGameThreadTime），以及其中花在 Cancel/AsyncLoad/Start 上的时间，毫秒
+	TArray<double> FrameMs;
+	TArray<double> ChurnMs;
+
+	// 每帧所有线程经过 GMalloc 的分配次数，以及 AsyncMixin 注册的 Ticker 数量
+	TArray<double> AllocsPerFrame;
+	TArray<double> ActiveTickers;
+
+	// 从开始加载到 OnFinishedLoading 的延迟，毫秒
+	TArray<double> LatencyMs;
+
+	int64 NumCycles = 0;
+	int64 NumCanceled = 0;
+
+	// 测试期间 GMalloc 被替换为计数代理
+	bool bCountingAllocations = false;
+	uint64 StartAllocations = 0;
+	uint64 LastAllocations = 0;
+	uint64 NumAllocations = 0;
+
+	uint64 StartUsedPhysical = 0;
+	uint64 PeakUsedPhysical = 0;
+	uint64 StartUsedVirtual = 0;
+	uint64 PeakUsedVirtual = 0;
+	int32 StartNumObjects = 0;
+	int32 PeakNumObjects = 0;
+};
@@ -0,0 +1,40 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AsyncAction_LoadTexture2DFromFilePath.h"
+
+#include "UtilityDemo.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AsyncAction_LoadTexture2DFromFilePath)
+
+UAsyncAction_LoadTexture2DFromFilePath* UAsyncAction_LoadTexture2DFromFilePath::LoadTexture2DFromFilePathAsync(UObject* WorldContextObject, const FString& ImagePath)
+{
+	UAsyncAction_LoadTexture2DFromFilePath* Action = NewObject<UAsyncAction_LoadTexture2DFromFilePath>();
+	Action->ImagePath = ImagePath;
+	Action->RegisterWithGameInstance(WorldContextObject);
+
+	return Action;
+}
+
+void UAsyncAction_LoadTexture2DFromFilePath::Activate()
+{
+	// 节点被取消或销毁后不再回调
+	UUtilityDemo::LoadTexture2DFromFilePathAsync(ImagePath, FOnTexture2DLoaded::CreateUObject(this, &ThisClass::HandleLoaded));
+}
+
+void UAsyncAction_LoadTexture2DFromFilePath::HandleLoaded(UTexture2D* Texture, int32 Width, int32 Height)
+{
+	if (ShouldBroadcastDelegates())
+	{
+		if (Texture != nullptr)
+		{
+			OnLoaded.Broadcast(Texture, Width, Height);
+		}
+		else
+		{
+			OnFailed.Broadcast(nullptr, 0, 0);
+		}
+	}
+
+	SetReadyToDestroy();
+}
@@ -0,0 +1,35 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/CancellableAsyncAction.h"
+#include "AsyncAction_LoadTexture2DFromFilePath.generated.h"
+
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FLoadTexture2DFromFilePathDelegate, UTexture2D*, Texture, int32, Width, int32, Height);
+
+// 异步从图片加载纹理的蓝图节点，见 UUtilityDemo::LoadTexture2DFromFilePathAsync
+UCLASS()
+class PRACTICE_API UAsyncAction_LoadTexture2DFromFilePath : public UCancellableAsyncAction
+{
+	GENERATED_BODY()
+
+public:
+	// 读取文件和解码在工作线程上，不会卡住游戏线程，适合一次加载很多用户图片
+	UFUNCTION(BlueprintCallable, Category = "Utility Demo", meta = (WorldContext = "WorldContextObject", BlueprintInternalUseOnly = "true"))
+	static UAsyncAction_LoadTexture2DFromFilePath* LoadTexture2DFromFilePathAsync(UObject* WorldContextObject, const FString& ImagePath);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+	FLoadTexture2DFromFilePathDelegate OnLoaded;
+
+	UPROPERTY(BlueprintAssignable)
+	FLoadTexture2DFromFilePathDelegate OnFailed;
+
+private:
+	void HandleLoaded(UTexture2D* Texture, int32 Width, int32 Height);
+
+	FString ImagePath;
+};
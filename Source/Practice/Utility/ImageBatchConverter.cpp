@@ -0,0 +1,484 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ImageBatchConverter.h"
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Tasks/Task.h"
+
+#if PRACTICE_WITH_LIBJPEGTURBO
+THIRD_PARTY_INCLUDES_START
+#include "turbojpeg.h"
+THIRD_PARTY_INCLUDES_END
+#endif
+
+struct FImageBatchConverter::FJob
+{
+	FString SourceName;
+	FString TargetName;
+
+	// 准入时预估的内存占用，完成时归还
+	int64 EstimatedBytes = 0;
+
+	// 只有解码出的像素跟着文件在两个任务之间传递，压缩数据和 JPG 数据都在线程的缓冲区里
+	TArray64<uint8> UncompressedRGBA;
+	int32 Width = 0;
+	int32 Height = 0;
+};
+
+namespace ImageBatchConverter
+{
+	static IImageWrapperModule& GetImageWrapperModule()
+	{
+		return FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	}
+
+	// 只读 PNG 文件头中的 IHDR 得到尺寸，用来在读取整个文件之前预估内存
+	static bool PeekPNGSize(const FString& FileName, int32& OutWidth, int32& OutHeight)
+	{
+		const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FileName, FILEREAD_Silent));
+		if (!Reader.IsValid() || (Reader->TotalSize() < 24))
+		{
+			return false;
+		}
+
+		uint8 Header[24];
+		Reader->Serialize(Header, sizeof(Header));
+
+		static const uint8 Signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		if (Reader->IsError() || (FMemory::Memcmp(Header, Signature, sizeof(Signature)) != 0) || (FMemory::Memcmp(Header + 12, "IHDR", 4) != 0))
+		{
+			return false;
+		}
+
+		OutWidth = (Header[16] << 24) | (Header[17] << 16) | (Header[18] << 8) | Header[19];
+		OutHeight = (Header[20] << 24) | (Header[21] << 16) | (Header[22] << 8) | Header[23];
+		return (OutWidth > 0) && (OutHeight > 0);
+	}
+
+	static double ToMB(uint64 Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+
+	// 任务之间复用的缓冲区，容量在文件之间保留，不用为每个文件重新分配
+	struct FScratch
+	{
+		// 超过这个容量的缓冲区用完就释放，偶尔一张特别大的图片不会让池里一直占着那么多内存
+		static constexpr int64 MaxRetainedBytes = 64 * 1024 * 1024;
+
+		TArray64<uint8> CompressedData;
+		TArray64<uint8> TargetData;
+
+#if PRACTICE_WITH_LIBJPEGTURBO
+		tjhandle Compressor = nullptr;
+
+		~FScratch()
+		{
+			if (Compressor != nullptr)
+			{
+				tjDestroy(Compressor);
+			}
+		}
+#endif
+
+		static void Trim(TArray64<uint8>& Buffer)
+		{
+			if (Buffer.Max() > MaxRetainedBytes)
+			{
+				Buffer.Empty();
+			}
+		}
+	};
+
+	static bool ReadFile(const FString& FileName, TArray64<uint8>& OutData)
+	{
+		const TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FileName, FILEREAD_Silent));
+		if (!Reader.IsValid())
+		{
+			return false;
+		}
+
+		// 不收缩，缓冲区已经够大时不会重新分配
+		OutData.SetNumUninitialized(Reader->TotalSize(), /*bAllowShrinking*/false);
+		Reader->Serialize(OutData.GetData(), OutData.Num());
+		return !Reader->IsError();
+	}
+
+	static bool EncodeJPEG(const TArray64<uint8>& UncompressedRGBA, int32 Width, int32 Height, int32 Quality, FScratch& Scratch)
+	{
+		// 0 和 JPEG 包装器一样使用默认质量
+		const int32 JpegQuality = (Quality > 0) ? FMath::Min(Quality, 100) : 85;
+
+#if PRACTICE_WITH_LIBJPEGTURBO
+		// 直接把解码出的像素交给编码器，结果写进线程的缓冲区。IImageWrapper::SetRaw 会先复制一份整张图片的像素
+		if (Scratch.Compressor == nullptr)
+		{
+			Scratch.Compressor = tjInitCompress();
+		}
+
+		// 按最坏情况预留，实际只会写入（提交）压缩后大小的内存
+		unsigned long TargetSize = tjBufSize(Width, Height, TJSAMP_420);
+		Scratch.TargetData.SetNumUninitialized(TargetSize, /*bAllowShrinking*/false);
+
+		unsigned char* TargetBuffer = Scratch.TargetData.GetData();
+		if ((Scratch.Compressor == nullptr)
+			|| (tjCompress2(Scratch.Compressor, UncompressedRGBA.GetData(), Width, 0, Height, TJPF_RGBA, &TargetBuffer, &TargetSize, TJSAMP_420, JpegQuality, TJFLAG_NOREALLOC) != 0))
+		{
+			Scratch.TargetData.Reset();
+			return false;
+		}
+
+		Scratch.TargetData.SetNum(TargetSize, /*bAllowShrinking*/false);
+		return true;
+#else
+		const TSharedPtr<IImageWrapper> TargetImageWrapper = GetImageWrapperModule().CreateImageWrapper(EImageFormat::JPEG);
+		if (TargetImageWrapper.IsValid() && TargetImageWrapper->SetRaw(UncompressedRGBA.GetData(), UncompressedRGBA.Num(), Width, Height, ERGBFormat::RGBA, 8))
+		{
+			Scratch.TargetData = TargetImageWrapper->GetCompressed(JpegQuality);
+			return Scratch.TargetData.Num() > 0;
+		}
+		return false;
+#endif
+	}
+}
+
+FImageBatchConverter::FImageBatchConverter(const FSettings& InSettings)
+	: Settings(InSettings)
+{
+	// 在调用线程上加载模块，工作线程上只使用已经加载的模块
+	ImageBatchConverter::GetImageWrapperModule();
+}
+
+FImageBatchConverter::~FImageBatchConverter() = default;
+
+const TCHAR* FImageBatchConverter::GetStageName(EStage Stage)
+{
+	switch (Stage)
+	{
+	case EStage::Read: return TEXT("Read");
+	case EStage::Decode: return TEXT("Decode");
+	case EStage::Encode: return TEXT("Encode");
+	case EStage::Write: return TEXT("Write");
+	default: return TEXT("Unknown");
+	}
+}
+
+void FImageBatchConverter::AddFile(const FString& SourceName, const FString& TargetName)
+{
+	FJob& Job = *Jobs.Add_GetRef(MakeUnique<FJob>());
+	Job.SourceName = SourceName;
+	Job.TargetName = TargetName;
+}
+
+void FImageBatchConverter::AddDirectory(const FString& SourceDirectory, const FString& TargetDirectory, bool bRecursive)
+{
+	TArray<FString> FileNames;
+	if (bRecursive)
+	{
+		IFileManager::Get().FindFilesRecursive(FileNames, *SourceDirectory, TEXT("*.png"), true, false);
+	}
+	else
+	{
+		IFileManager::Get().FindFiles(FileNames, *(SourceDirectory / TEXT("*.png")), true, false);
+		for (FString& FileName : FileNames)
+		{
+			FileName = SourceDirectory / FileName;
+		}
+	}
+
+	for (const FString& FileName : FileNames)
+	{
+		FString RelativeName = FileName;
+		FPaths::MakePathRelativeTo(RelativeName, *(SourceDirectory / TEXT("")));
+		AddFile(FileName, FPaths::ChangeExtension(TargetDirectory / RelativeName, TEXT("jpg")));
+	}
+}
+
+bool FImageBatchConverter::ExecuteStage(FJob& Job, EStage Stage, int32 Quality, ImageBatchConverter::FScratch& Scratch, int64& OutBytes)
+{
+	using namespace ImageBatchConverter;
+
+	switch (Stage)
+	{
+	case EStage::Read:
+		{
+			const bool bSucceeded = ReadFile(Job.SourceName, Scratch.CompressedData);
+			OutBytes = Scratch.CompressedData.Num();
+			return bSucceeded;
+		}
+	case EStage::Decode:
+		{
+			// 包装器会复制一份压缩数据，GetRaw 把解码结果移动出来，不再复制
+			bool bSucceeded = false;
+			const TSharedPtr<IImageWrapper> SourceImageWrapper = GetImageWrapperModule().CreateImageWrapper(EImageFormat::PNG);
+			if (SourceImageWrapper.IsValid() && SourceImageWrapper->SetCompressed(Scratch.CompressedData.GetData(), Scratch.CompressedData.Num()))
+			{
+				bSucceeded = SourceImageWrapper->GetRaw(ERGBFormat::RGBA, 8, Job.UncompressedRGBA);
+				Job.Width = SourceImageWrapper->GetWidth();
+				Job.Height = SourceImageWrapper->GetHeight();
+			}
+			OutBytes = Scratch.CompressedData.Num();
+			FScratch::Trim(Scratch.CompressedData);
+			return bSucceeded;
+		}
+	case EStage::Encode:
+		{
+			const bool bSucceeded = EncodeJPEG(Job.UncompressedRGBA, Job.Width, Job.Height, Quality, Scratch);
+			OutBytes = Job.UncompressedRGBA.Num();
+			Job.UncompressedRGBA.Empty();
+			return bSucceeded;
+		}
+	case EStage::Write:
+		{
+			IFileManager::Get().MakeDirectory(*FPaths::GetPath(Job.TargetName), true);
+			const bool bSucceeded = FFileHelper::SaveArrayToFile(Scratch.TargetData, *Job.TargetName);
+			OutBytes = Scratch.TargetData.Num();
+			FScratch::Trim(Scratch.TargetData);
+			return bSucceeded;
+		}
+	default:
+		return false;
+	}
+}
+
+void FImageBatchConverter::EstimateMemory(FJob& Job)
+{
+	// 解码时包装器里的压缩数据副本 + 解码出的 RGBA + 编码结果，线程的缓冲区不算在内
+	const int64 FileSize = FMath::Max<int64>(IFileManager::Get().FileSize(*Job.SourceName), 0);
+	int32 Width = 0;
+	int32 Height = 0;
+	const int64 RawSize = ImageBatchConverter::PeekPNGSize(Job.SourceName, Width, Height) ? int64(Width) * Height * 4 : FileSize * 4;
+	Job.EstimatedBytes = FMath::Max<int64>(FileSize + RawSize + RawSize / 4, 1);
+}
+
+UE::Tasks::FTask FImageBatchConverter::Admit(FJob& Job)
+{
+	InFlightBytes += Job.EstimatedBytes;
+	++InFlightFiles;
+	PeakInFlightBytes = FMath::Max<int64>(PeakInFlightBytes, InFlightBytes);
+
+	return LaunchStage(Job, EStage::Read);
+}
+
+UE::Tasks::FTask FImageBatchConverter::LaunchStage(FJob& Job, EStage Stage)
+{
+	// 读取和解码在一个任务里，编码和写入在一个任务里，这样压缩数据和 JPG 数据可以留在任务借用的缓冲区里
+	const EStage LastStage = (Stage == EStage::Read) ? EStage::Decode : EStage::Write;
+
+	// 靠后的阶段优先，先把手上的文件做完再读新的
+	const UE::Tasks::ETaskPriority Priority = (Stage >= EStage::Encode) ? UE::Tasks::ETaskPriority::High : UE::Tasks::ETaskPriority::Normal;
+
+	return UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &Job, Stage, LastStage]
+	{
+		TUniquePtr<ImageBatchConverter::FScratch> Scratch = AcquireScratch();
+
+		bool bSucceeded = true;
+		for (int32 StageIndex = int32(Stage); bSucceeded && (StageIndex <= int32(LastStage)); ++StageIndex)
+		{
+			bSucceeded = RunStage(Job, EStage(StageIndex), *Scratch);
+		}
+
+		ReleaseScratch(MoveTemp(Scratch));
+
+		if (!bSucceeded || (LastStage == EStage::Write))
+		{
+			FinishJob(Job, bSucceeded);
+		}
+		else
+		{
+			// 嵌套的任务结束后这个任务才算完成，Run() 只需要等待每个文件的第一个任务
+			UE::Tasks::AddNested(LaunchStage(Job, EStage::Encode));
+		}
+	}, Priority);
+}
+
+TUniquePtr<ImageBatchConverter::FScratch> FImageBatchConverter::AcquireScratch()
+{
+	{
+		FScopeLock Lock(&ScratchLock);
+		if (ScratchPool.Num() > 0)
+		{
+			return ScratchPool.Pop(/*bAllowShrinking*/false);
+		}
+	}
+
+	return MakeUnique<ImageBatchConverter::FScratch>();
+}
+
+void FImageBatchConverter::ReleaseScratch(TUniquePtr<ImageBatchConverter::FScratch>&& Scratch)
+{
+	FScopeLock Lock(&ScratchLock);
+	ScratchPool.Add(MoveTemp(Scratch));
+}
+
+bool FImageBatchConverter::RunStage(FJob& Job, EStage Stage, ImageBatchConverter::FScratch& Scratch)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	int64 Bytes = 0;
+	const bool bSucceeded = ExecuteStage(Job, Stage, Settings.Quality, Scratch, Bytes);
+
+	FStageCounters& Counters = StageCounters[int32(Stage)];
+	++Counters.NumFiles;
+	Counters.BusyCycles += FPlatformTime::Cycles64() - StartCycles;
+	Counters.Bytes += Bytes;
+
+	if (!bSucceeded)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("转换 %s 失败，阶段 %s"), *Job.SourceName, GetStageName(Stage));
+	}
+
+	return bSucceeded;
+}
+
+bool FImageBatchConverter::ConvertFile(const FString& SourceName, const FString& TargetName, int32 Quality)
+{
+	using namespace ImageBatchConverter;
+
+	FJob Job;
+	Job.SourceName = SourceName;
+	Job.TargetName = TargetName;
+
+	const uint64 StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+
+	// 只用这一次，返回时释放
+	FScratch Scratch;
+
+	bool bSucceeded = true;
+	for (int32 StageIndex = 0; bSucceeded && (StageIndex < int32(EStage::Num)); ++StageIndex)
+	{
+		int64 Bytes = 0;
+		bSucceeded = ExecuteStage(Job, EStage(StageIndex), Quality, Scratch, Bytes);
+	}
+
+	// 进程峰值可能是之前留下的，比开始时已使用的内存高出多少只是上限
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	UE_LOG(LogTemp, Verbose, TEXT("转换 %s：开始时物理内存 %.1f MB，结束时 %.1f MB，进程峰值 %.1f MB"),
+	       *SourceName, ToMB(StartUsedPhysical), ToMB(MemoryStats.UsedPhysical), ToMB(MemoryStats.PeakUsedPhysical));
+
+	return bSucceeded;
+}
+
+void FImageBatchConverter::FinishJob(FJob& Job, bool bSucceeded)
+{
+	Job.UncompressedRGBA.Empty();
+
+	if (!bSucceeded)
+	{
+		++NumFailed;
+	}
+
+	InFlightBytes -= Job.EstimatedBytes;
+	--InFlightFiles;
+	++NumCompleted;
+	CompletionEvent->Trigger();
+}
+
+void FImageBatchConverter::SampleMemory()
+{
+	MaxSampledUsedPhysical = FMath::Max<uint64>(MaxSampledUsedPhysical, FPlatformMemory::GetStats().UsedPhysical);
+}
+
+FImageBatchConverter::FStats FImageBatchConverter::GetStats() const
+{
+	FStats Stats;
+	Stats.NumFiles = Jobs.Num();
+	Stats.NumCompleted = NumCompleted;
+	Stats.NumFailed = NumFailed;
+	Stats.WallSeconds = FPlatformTime::Seconds() - StartTime;
+	Stats.PeakInFlightBytes = PeakInFlightBytes;
+	Stats.StartUsedPhysical = StartUsedPhysical;
+	Stats.MaxSampledUsedPhysical = MaxSampledUsedPhysical;
+	Stats.PeakUsedPhysical = FPlatformMemory::GetStats().PeakUsedPhysical;
+
+	for (int32 StageIndex = 0; StageIndex < int32(EStage::Num); ++StageIndex)
+	{
+		Stats.Stages[StageIndex].NumFiles = StageCounters[StageIndex].NumFiles;
+		Stats.Stages[StageIndex].BusySeconds = FPlatformTime::ToSeconds64(StageCounters[StageIndex].BusyCycles);
+		Stats.Stages[StageIndex].Bytes = StageCounters[StageIndex].Bytes;
+	}
+
+	return Stats;
+}
+
+FImageBatchConverter::FStats FImageBatchConverter::Run(const FOnProgress& OnProgress)
+{
+	const int64 MaxInFlightBytes = int64(FMath::Max(Settings.MaxInFlightMB, 1)) * 1024 * 1024;
+	const int32 MaxInFlightFiles = (Settings.MaxInFlightFiles > 0) ? Settings.MaxInFlightFiles : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads() * 2, 2);
+
+	StartTime = FPlatformTime::Seconds();
+	double LastProgressTime = StartTime;
+
+	StartUsedPhysical = MaxSampledUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+
+	// 任务引用着 this 和各自的 FJob，返回前必须全部结束
+	TArray<UE::Tasks::FTask> Tasks;
+	Tasks.Reserve(Jobs.Num());
+
+	int32 NextJob = 0;
+	while (NumCompleted < Jobs.Num())
+	{
+		// 准入尽可能多的文件，但至少保证有一个在处理
+		while (NextJob < Jobs.Num())
+		{
+			FJob& Job = *Jobs[NextJob];
+			if (Job.EstimatedBytes == 0)
+			{
+				EstimateMemory(Job);
+			}
+
+			if ((InFlightFiles > 0) && ((InFlightFiles >= MaxInFlightFiles) || (InFlightBytes + Job.EstimatedBytes > MaxInFlightBytes)))
+			{
+				break;
+			}
+
+			Tasks.Add(Admit(Job));
+			++NextJob;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		const double UntilProgress = FMath::Max(LastProgressTime + Settings.ProgressInterval - Now, 0.0);
+		CompletionEvent->Wait(FTimespan::FromSeconds(UntilProgress));
+		SampleMemory();
+
+		if (FPlatformTime::Seconds() - LastProgressTime >= Settings.ProgressInterval)
+		{
+			LastProgressTime = FPlatformTime::Seconds();
+			OnProgress.ExecuteIfBound(GetStats());
+		}
+	}
+
+	// 最后一个文件计入 NumCompleted 之后，它的任务还要触发 CompletionEvent 才结束
+	UE::Tasks::Wait(Tasks);
+	SampleMemory();
+
+	// 批量转换结束就释放缓冲区，不在工作线程上留着
+	ScratchPool.Empty();
+
+	const FStats Stats = GetStats();
+	OnProgress.ExecuteIfBound(Stats);
+	return Stats;
+}
+
+void FImageBatchConverter::FStats::Log() const
+{
+	using namespace ImageBatchConverter;
+
+	UE_LOG(LogTemp, Display, TEXT("转换了 %d / %d 个文件，失败 %d 个，用时 %.2f 秒（%.1f 个/秒），准入预估峰值 %.1f MB"),
+	       NumCompleted, NumFiles, NumFailed, WallSeconds, WallSeconds > 0.0 ? NumCompleted / WallSeconds : 0.0, ToMB(PeakInFlightBytes));
+	UE_LOG(LogTemp, Display, TEXT("  实测物理内存：开始时 %.1f MB，采样最大 %.1f MB，进程峰值 %.1f MB"),
+	       ToMB(StartUsedPhysical), ToMB(MaxSampledUsedPhysical), ToMB(PeakUsedPhysical));
+
+	for (int32 StageIndex = 0; StageIndex < int32(EStage::Num); ++StageIndex)
+	{
+		const FStageStats& Stage = Stages[StageIndex];
+		UE_LOG(LogTemp, Display, TEXT("  %-6s %6d 个文件，累计 %8.2f 秒，单线程 %8.1f MB/s"),
+		       GetStageName(EStage(StageIndex)), Stage.NumFiles, Stage.BusySeconds, Stage.GetThroughputMBps());
+	}
+}
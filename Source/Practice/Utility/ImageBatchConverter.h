@@ -0,0 +1,160 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Event.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+
+namespace ImageBatchConverter
+{
+	struct FScratch;
+}
+
+/**
+ * 批量把 PNG 转换为 JPG。
+ *
+ * 每个文件依次经过 读取 → 解码 → 编码 → 写入 四个阶段，读取和解码是一个 UE::Tasks 任务，完成后启动编码和写入的任务，
+ * 多个文件同时在流水线中，所以 IO 和各个核心上的编解码可以重叠进行。编码和写入的优先级更高，先把已经解码的文件完成，尽快释放内存。
+ *
+ * 压缩数据和 JPG 数据放在转换器的缓冲区池里，每个任务借用一组，用完还回去给后面的任务复用，池的大小不超过同时执行的任务数。
+ * Run() 结束时释放整个池，批量转换之后不会在工作线程上留着缓冲区。只有解码出的像素跟着文件传递，并且直接交给编码器，不再复制一份。
+ *
+ * 调用 Run() 的线程负责准入：只有当正在处理的文件的预估内存之和不超过 MaxInFlightMB 时才会开始读取下一个文件，
+ * 预估值由 PNG 文件头中的尺寸计算，所以内存占用有上限，与文件总数无关。Run() 会阻塞到所有文件处理完，期间定期在调用线程上报告进度。
+ * 编码和写入的任务嵌套在读取和解码的任务里，Run() 返回前会等待所有任务结束，之后不会再有任务访问转换器。
+ */
+class PRACTICE_API FImageBatchConverter
+{
+public:
+	enum class EStage : uint8
+	{
+		Read,
+		Decode,
+		Encode,
+		Write,
+
+		Num
+	};
+
+	struct FSettings
+	{
+		// JPEG 压缩质量，1 ~ 100
+		int32 Quality = 85;
+
+		// 同时处理的文件的预估内存上限，至少会处理一个文件
+		int32 MaxInFlightMB = 512;
+
+		// 同时处理的文件数量上限，0 表示工作线程数量的两倍
+		int32 MaxInFlightFiles = 0;
+
+		// 报告进度的间隔，秒
+		float ProgressInterval = 1.0f;
+	};
+
+	struct FStageStats
+	{
+		int32 NumFiles = 0;
+
+		// 所有线程上花在这个阶段的时间之和
+		double BusySeconds = 0.0;
+
+		// 这个阶段处理的数据量，读取和解码是压缩数据，编码是原始像素，写入是 JPG 数据
+		int64 Bytes = 0;
+
+		/** 单个线程上的吞吐量，MB/s */
+		double GetThroughputMBps() const { return BusySeconds > 0.0 ? Bytes / (1024.0 * 1024.0) / BusySeconds : 0.0; }
+	};
+
+	struct FStats
+	{
+		int32 NumFiles = 0;
+		int32 NumCompleted = 0;
+		int32 NumFailed = 0;
+		double WallSeconds = 0.0;
+
+		// 准入时按文件头预估的内存之和的最大值，不是实测值
+		int64 PeakInFlightBytes = 0;
+
+		// 实测的进程物理内存：Run() 开始时已使用的，每个文件完成时采样到的最大值，以及 FPlatformMemory 报告的进程峰值。
+		// 采样只在文件之间进行，文件处理中途的峰值只反映在进程峰值里，进程峰值也可能是转换之前留下的
+		uint64 StartUsedPhysical = 0;
+		uint64 MaxSampledUsedPhysical = 0;
+		uint64 PeakUsedPhysical = 0;
+
+		FStageStats Stages[int32(EStage::Num)];
+
+		void Log() const;
+	};
+
+	DECLARE_DELEGATE_OneParam(FOnProgress, const FStats&);
+
+	explicit FImageBatchConverter(const FSettings& InSettings = FSettings());
+	~FImageBatchConverter();
+
+	/** 添加一个要转换的文件 */
+	void AddFile(const FString& SourceName, const FString& TargetName);
+
+	/** 添加目录中的所有 PNG 文件，输出到 TargetDirectory 下相同的相对路径 */
+	void AddDirectory(const FString& SourceDirectory, const FString& TargetDirectory, bool bRecursive = true);
+
+	int32 NumFiles() const { return Jobs.Num(); }
+
+	/** 转换所有添加的文件，阻塞到全部完成，OnProgress 在调用线程上调用 */
+	FStats Run(const FOnProgress& OnProgress = FOnProgress());
+
+	/** 在调用线程上转换一个文件，和批量转换使用相同的编码路径，缓冲区在返回时释放 */
+	static bool ConvertFile(const FString& SourceName, const FString& TargetName, int32 Quality = 0);
+
+	static const TCHAR* GetStageName(EStage Stage);
+
+private:
+	struct FJob;
+
+	void EstimateMemory(FJob& Job);
+	UE::Tasks::FTask Admit(FJob& Job);
+	UE::Tasks::FTask LaunchStage(FJob& Job, EStage Stage);
+	bool RunStage(FJob& Job, EStage Stage, ImageBatchConverter::FScratch& Scratch);
+
+	/** 执行一个阶段，读取和解码、编码和写入必须使用同一组缓冲区，中间数据在缓冲区里 */
+	static bool ExecuteStage(FJob& Job, EStage Stage, int32 Quality, ImageBatchConverter::FScratch& Scratch, int64& OutBytes);
+	void FinishJob(FJob& Job, bool bSucceeded);
+
+	TUniquePtr<ImageBatchConverter::FScratch> AcquireScratch();
+	void ReleaseScratch(TUniquePtr<ImageBatchConverter::FScratch>&& Scratch);
+
+	void SampleMemory();
+	FStats GetStats() const;
+
+	FSettings Settings;
+	TArray<TUniquePtr<FJob>> Jobs;
+
+	// 每个完成的文件触发一次，唤醒 Run() 准入下一个文件
+	FEventRef CompletionEvent;
+
+	std::atomic<int64> InFlightBytes = 0;
+	std::atomic<int32> InFlightFiles = 0;
+	std::atomic<int32> NumCompleted = 0;
+	std::atomic<int32> NumFailed = 0;
+	int64 PeakInFlightBytes = 0;
+	double StartTime = 0.0;
+
+	uint64 StartUsedPhysical = 0;
+	uint64 MaxSampledUsedPhysical = 0;
+
+	// 空闲的缓冲区，任务开始时借用，结束时归还
+	FCriticalSection ScratchLock;
+	TArray<TUniquePtr<ImageBatchConverter::FScratch>> ScratchPool;
+
+	struct FStageCounters
+	{
+		std::atomic<int32> NumFiles = 0;
+		std::atomic<uint64> BusyCycles = 0;
+		std::atomic<int64> Bytes = 0;
+	};
+
+	FStageCounters StageCounters[int32(EStage::Num)];
+};
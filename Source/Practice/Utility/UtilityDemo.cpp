@@ -5,9 +5,63 @@
 
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
+#include "ImageBatchConverter.h"
 #include "XmlFile.h"
 #include "XmlNode.h"
+#include "Async/Async.h"
 #include "HAL/FileManagerGeneric.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+
+namespace UtilityDemo
+{
+	static int32 MaxConcurrentTextureDecodes = 4;
+	static FAutoConsoleVariableRef CVarMaxConcurrentTextureDecodes(
+		TEXT("Utility.LoadTexture.MaxConcurrentDecodes"),
+		MaxConcurrentTextureDecodes,
+		TEXT("LoadTexture2DFromFilePathAsync 同时在工作线程上解码的图片数量上限，解码出的像素要在内存中留到游戏线程创建纹理为止"));
+
+	struct FTextureDecodeRequest
+	{
+		FString ImagePath;
+		FOnTexture2DLoaded OnLoaded;
+	};
+
+	// 只在游戏线程上访问
+	static TArray<FTextureDecodeRequest> PendingTextureDecodes;
+	static int32 NumTextureDecodesInFlight = 0;
+
+	// 在工作线程上读取并解码图片，格式由文件内容判断
+	static bool DecodeImageFile(const FString& ImagePath, TArray64<uint8>& OutRGBA, int32& OutWidth, int32& OutHeight)
+	{
+		TArray64<uint8> CompressedData;
+		if (!FFileHelper::LoadFileToArray(CompressedData, *ImagePath, FILEREAD_Silent))
+		{
+			return false;
+		}
+
+		// 模块已经在游戏线程上加载，这里只是取出来
+		IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		const EImageFormat ImageFormat = ImageWrapperModule.DetectImageFormat(CompressedData.GetData(), CompressedData.Num());
+		if (ImageFormat == EImageFormat::Invalid)
+		{
+			return false;
+		}
+
+		const TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(ImageFormat);
+		if (ImageWrapper.IsValid() && ImageWrapper->SetCompressed(CompressedData.GetData(), CompressedData.Num()))
+		{
+			// 包装器里已经有一份压缩数据了
+			CompressedData.Empty();
+
+			OutWidth = ImageWrapper->GetWidth();
+			OutHeight = ImageWrapper->GetHeight();
+			return ImageWrapper->GetRaw(ERGBFormat::RGBA, 8, OutRGBA);
+		}
+
+		return false;
+	}
+}
 
 void UUtilityDemo::RegexDemo()
 {
@@ -101,46 +155,52 @@ bool UUtilityDemo::CovertPNG2JPG(const FString& SourceName, const FString& Targe
 {
 	check(SourceName.EndsWith(TEXT(".png")) && TargetName.EndsWith(TEXT(".jpg")));
 
-	// TODO 这个函数的实现方式不是 IImageWrapperModule 注释中推荐的，是比较底层的方式
-	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-
-	const TSharedPtr<IImageWrapper> SourceImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
-	const TSharedPtr<IImageWrapper> TargetImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::JPEG);
-
-	TArray<uint8> SourceImageData;
-	TArray<uint8> TargetImageData;
-
 	if (!FPlatformFileManager::Get().GetPlatformFile().FileExists(*SourceName))
 	{
 		// 文件不存在
 		return false;
 	}
 
-	if (!FFileHelper::LoadFileToArray(SourceImageData, *SourceName))
+	// 与批量转换使用相同的路径：解码出的像素直接交给编码器，缓冲区在返回时释放
+	return FImageBatchConverter::ConvertFile(SourceName, TargetName);
+}
+
+int32 UUtilityDemo::ConvertPNG2JPGInDirectory(const FString& SourceDirectory, const FString& TargetDirectory, int32 Quality, int32 MaxInFlightMB)
+{
+	FImageBatchConverter::FSettings Settings;
+	Settings.Quality = Quality;
+	Settings.MaxInFlightMB = MaxInFlightMB;
+
+	FImageBatchConverter Converter(Settings);
+	Converter.AddDirectory(SourceDirectory, TargetDirectory);
+	return RunImageBatchConverter(Converter);
+}
+
+int32 UUtilityDemo::ConvertPNG2JPGBatch(const TArray<FString>& SourceNames, const FString& TargetDirectory, int32 Quality, int32 MaxInFlightMB)
+{
+	FImageBatchConverter::FSettings Settings;
+	Settings.Quality = Quality;
+	Settings.MaxInFlightMB = MaxInFlightMB;
+
+	FImageBatchConverter Converter(Settings);
+	for (const FString& SourceName : SourceNames)
 	{
-		// 文件读取失败
-		return false;
+		Converter.AddFile(SourceName, TargetDirectory / FPaths::GetBaseFilename(SourceName) + TEXT(".jpg"));
 	}
+	return RunImageBatchConverter(Converter);
+}
+
+int32 UUtilityDemo::RunImageBatchConverter(FImageBatchConverter& Converter)
+{
+	UE_LOG(LogTemp, Display, TEXT("开始转换 %d 个文件"), Converter.NumFiles());
 
-	if (SourceImageWrapper.IsValid() && SourceImageWrapper->SetCompressed(SourceImageData.GetData(), SourceImageData.Num()))
+	const FImageBatchConverter::FStats Stats = Converter.Run(FImageBatchConverter::FOnProgress::CreateLambda([](const FImageBatchConverter::FStats& Progress)
 	{
-		if (TArray<uint8> UncompressedRGBA; SourceImageWrapper->GetRaw(ERGBFormat::RGBA, 8, UncompressedRGBA))
-		{
-			const int32 Height = SourceImageWrapper->GetHeight();
-			const int32 Width = SourceImageWrapper->GetWidth();
+		UE_LOG(LogTemp, Display, TEXT("转换进度 %d / %d"), Progress.NumCompleted, Progress.NumFiles);
+	}));
 
-			if (TargetImageWrapper->SetRaw(UncompressedRGBA.GetData(), UncompressedRGBA.Num(), Width, Height, ERGBFormat::RGBA, 8))
-			{
-				TargetImageData = TargetImageWrapper->GetCompressed();
-				if (!FFileManagerGeneric::Get().DirectoryExists(*TargetName))
-				{
-					FFileManagerGeneric::Get().MakeDirectory(*FPaths::GetPath(TargetName), true);
-				}
-				return FFileHelper::SaveArrayToFile(TargetImageData, *TargetName);
-			}
-		}
-	}
-	return false;
+	Stats.Log();
+	return Stats.NumCompleted - Stats.NumFailed;
 }
 
 
@@ -174,17 +234,11 @@ UTexture2D* UUtilityDemo::LoadTexture2DFromBytesAndExtension(
 	{
 		if (TArray<uint8> UncompressedRGBA; ImageWrapper->GetRaw(ERGBFormat::RGBA, 8, UncompressedRGBA)) // 获取原始图片数据
 		{
-			Texture = UTexture2D::CreateTransient(ImageWrapper->GetWidth(), ImageWrapper->GetHeight(), PF_R8G8B8A8);
+			Texture = CreateTexture2DFromRGBA(UncompressedRGBA.GetData(), UncompressedRGBA.Num(), ImageWrapper->GetWidth(), ImageWrapper->GetHeight());
 			if (Texture != nullptr)
 			{
-				// 通过内存复制，填充原始 RGB 数据到贴图的数据中
 				OutWidth = ImageWrapper->GetWidth();
 				OutHeight = ImageWrapper->GetHeight();
-
-				void* TextureData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-				FMemory::Memcpy(TextureData, UncompressedRGBA.GetData(), UncompressedRGBA.Num());
-				Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
-				Texture->UpdateResource();
 			}
 		}
 	}
@@ -208,3 +262,65 @@ UTexture2D* UUtilityDemo::LoadTexture2DFromFilePath(FString& ImagePath, int32& O
 
 	return LoadTexture2DFromBytesAndExtension(ImagePath, CompressedData.GetData(), CompressedData.Num(), OutWidth, OutHeight);
 }
+
+UTexture2D* UUtilityDemo::CreateTexture2DFromRGBA(const uint8* RGBA, int64 Size, int32 Width, int32 Height)
+{
+	check(IsInGameThread());
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PF_R8G8B8A8);
+	if (Texture != nullptr)
+	{
+		// 通过内存复制，填充原始 RGB 数据到贴图的数据中
+		void* TextureData = Texture->GetPlatformData()->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+		FMemory::Memcpy(TextureData, RGBA, Size);
+		Texture->GetPlatformData()->Mips[0].BulkData.Unlock();
+		Texture->UpdateResource();
+	}
+	return Texture;
+}
+
+void UUtilityDemo::LoadTexture2DFromFilePathAsync(const FString& ImagePath, const FOnTexture2DLoaded& OnLoaded)
+{
+	check(IsInGameThread());
+
+	// 工作线程上只能取出已经加载的模块
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+	UtilityDemo::PendingTextureDecodes.Add(UtilityDemo::FTextureDecodeRequest{ ImagePath, OnLoaded });
+	StartTextureDecodes();
+}
+
+void UUtilityDemo::StartTextureDecodes()
+{
+	using namespace UtilityDemo;
+
+	while ((PendingTextureDecodes.Num() > 0) && (NumTextureDecodesInFlight < FMath::Max(MaxConcurrentTextureDecodes, 1)))
+	{
+		FTextureDecodeRequest Request = MoveTemp(PendingTextureDecodes[0]);
+		PendingTextureDecodes.RemoveAt(0, 1, /*bAllowShrinking*/false);
+		++NumTextureDecodesInFlight;
+
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [Request = MoveTemp(Request)]() mutable
+		{
+			TArray64<uint8> RGBA;
+			int32 Width = 0;
+			int32 Height = 0;
+			const bool bDecoded = DecodeImageFile(Request.ImagePath, RGBA, Width, Height);
+
+			AsyncTask(ENamedThreads::GameThread, [Request = MoveTemp(Request), RGBA = MoveTemp(RGBA), Width, Height, bDecoded]()
+			{
+				--NumTextureDecodesInFlight;
+
+				UTexture2D* Texture = bDecoded ? CreateTexture2DFromRGBA(RGBA.GetData(), RGBA.Num(), Width, Height) : nullptr;
+				if (Texture == nullptr)
+				{
+					UE_LOG(LogTemp, Warning, TEXT("加载图片失败: %s"), *Request.ImagePath);
+				}
+
+				// 先开始下一个解码，回调里发起的请求排在已经排队的请求后面
+				StartTextureDecodes();
+				Request.OnLoaded.ExecuteIfBound(Texture, Texture ? Width : 0, Texture ? Height : 0);
+			});
+		}, UE::Tasks::ETaskPriority::BackgroundNormal);
+	}
+}
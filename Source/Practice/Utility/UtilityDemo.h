@@ -7,8 +7,12 @@
 #include "UtilityDemo.generated.h"
 
 
+class FImageBatchConverter;
 class IImageWrapper;
 
+// Texture 为空表示加载失败
+DECLARE_DELEGATE_ThreeParams(FOnTexture2DLoaded, UTexture2D* /*Texture*/, int32 /*Width*/, int32 /*Height*/);
+
 UCLASS()
 class PRACTICE_API UUtilityDemo : public UBlueprintFunctionLibrary
 {
@@ -36,13 +40,33 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Utility Demo")
 	static bool CovertPNG2JPG(const FString& SourceName, const FString& TargetName);
 
+	// 在工作线程上流水线式地批量转换目录中的 PNG，阻塞到全部完成，返回成功转换的数量
+	UFUNCTION(BlueprintCallable, Category = "Utility Demo")
+	static int32 ConvertPNG2JPGInDirectory(const FString& SourceDirectory, const FString& TargetDirectory, int32 Quality = 85, int32 MaxInFlightMB = 512);
+
+	// 同上，转换给定的 PNG 文件，输出到 TargetDirectory 下的同名 JPG
+	UFUNCTION(BlueprintCallable, Category = "Utility Demo")
+	static int32 ConvertPNG2JPGBatch(const TArray<FString>& SourceNames, const FString& TargetDirectory, int32 Quality = 85, int32 MaxInFlightMB = 512);
+
 	// 从图片直接加载纹理
 	UFUNCTION(BlueprintCallable, Category = "Utility Demo")
 	static UTexture2D* LoadTexture2DFromFilePath(FString& ImagePath, int32& OutWidth, int32& OutHeight);
 
+	// 异步从图片加载纹理，读取文件和解码在工作线程上，游戏线程上只创建纹理并复制像素，完成后在游戏线程上调用 OnLoaded。
+	// 同时解码的图片数量受 Utility.LoadTexture.MaxConcurrentDecodes 限制，其余的按请求顺序排队。蓝图中使用 UAsyncAction_LoadTexture2DFromFilePath
+	static void LoadTexture2DFromFilePathAsync(const FString& ImagePath, const FOnTexture2DLoaded& OnLoaded);
+
 private:
 	static UTexture2D* LoadTexture2DFromBytesAndExtension(const FString& ImagePath, const uint8* InCompressedData, int32 InCompressedSize, int32& OutWidth,
 	                                                      int32& OutHeight);
 
 	static TSharedPtr<IImageWrapper> GetImageWrapperByExtension(const FString path);
+
+	// 创建纹理并把 RGBA 像素复制到第一级 Mip 中，只能在游戏线程上调用
+	static UTexture2D* CreateTexture2DFromRGBA(const uint8* RGBA, int64 Size, int32 Width, int32 Height);
+
+	// 在队列中还有请求、并且正在解码的数量没有达到上限时开始解码
+	static void StartTextureDecodes();
+
+	static int32 RunImageBatchConverter(FImageBatchConverter& Converter);
 };